@@ -0,0 +1,234 @@
+/*
+ *  Název programu: Benchmark implementací kalendáře SIMLIB
+ *
+ *  Měří všechny kalendáře registrované v SetCalendar() (list, cq, heap, ladder)
+ *  na dvou typech zátěže:
+ *    - hold model: konstantní počet naplánovaných událostí, každá událost
+ *      se po provedení znovu naplánuje (jedno vyjmutí + jedno vložení)
+ *    - trace: proud událostí scénáře z main.cpp - příchody požadavků podle
+ *      dataset.hpp a jejich dokončení po době zpracování závislé na zátěži
+ *  pro 10 až 10^6 čekajících událostí.
+ *
+ *  Výstup je CSV: workload, calendar, pending, ops, ns_per_op, cache_misses_per_op
+ *  (cache misses přes perf_event_open, pokud je dostupný, jinak prázdné).
+ *
+ *  Použití: ./bench_calendar [max_pending]
+ */
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "simlib.h"
+#include "dataset.hpp"
+
+using namespace std;
+
+const long MAX_OPS = 2000000;           // Maximální počet operací na jedno měření
+const double TIME_BUDGET = 2.0;         // Časový limit jednoho měření v sekundách
+const double SERVICE_TIME = 0.1;        // Parametry modelu z main.cpp
+const double ALPHA = 0.02;
+const int REQUESTS_MULTIPLIER = 25;
+const int SIMULATION_INTERVAL = 60;
+const double MEAN_CONTAINER_LOAD = 20;  // Střední zátěž kontejneru pro dobu zpracování
+
+
+/* ČÍTAČ CACHE MISSES (perf_event_open) */
+class CacheMissCounter {
+    int fd;
+public:
+    CacheMissCounter() : fd(-1) {
+#ifdef __linux__
+        perf_event_attr attr = {};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#endif
+    }
+    ~CacheMissCounter() {
+#ifdef __linux__
+        if (fd >= 0)
+            close(fd);
+#endif
+    }
+    bool Available() const { return fd >= 0; }
+    void Start() {
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+#endif
+    }
+    long long Stop() {
+        long long count = -1;
+#ifdef __linux__
+        if (fd >= 0) {
+            ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(fd, &count, sizeof(count)) != sizeof(count))
+                count = -1;
+        }
+#endif
+        return count;
+    }
+};
+
+
+/* MĚŘENÍ JEDNOHO BĚHU */
+CacheMissCounter cache_misses;
+chrono::steady_clock::time_point start_time;
+long ops = 0;
+double elapsed = 0;
+long long misses = -1;
+
+// Provede se po každé operaci, vrací true, pokud má měření skončit
+bool CountOperation() {
+    ++ops;
+    if (ops >= MAX_OPS || ((ops & 1023) == 0 &&
+            chrono::duration<double>(chrono::steady_clock::now() - start_time).count() > TIME_BUDGET)) {
+        misses = cache_misses.Stop();
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        Stop();
+        return true;
+    }
+    return false;
+}
+
+void StartMeasurement() {
+    ops = 0;
+    misses = -1;
+    start_time = chrono::steady_clock::now();
+    cache_misses.Start();
+}
+
+
+/* HOLD MODEL */
+class HoldEvent : public Event {
+    void Behavior() {
+        if (CountOperation())
+            return;
+        Activate(Time + Exponential(1.0));
+    }
+};
+
+void HoldModel(int pending) {
+    vector<double> times(pending);
+    for (double &t : times)
+        t = Exponential(1.0);
+    sort(times.begin(), times.end());   // vzestupné vkládání je levné pro všechny kalendáře
+    for (double t : times)
+        (new HoldEvent)->Activate(t);
+}
+
+
+/* TRACE - PROUD UDÁLOSTÍ SCÉNÁŘE Z main.cpp */
+double rate_scale = 1.0;    // Násobek intenzity příchodů pro požadovaný počet čekajících událostí
+
+class Completion;
+vector<Completion*> free_completions;   // Znovupoužitelné události dokončení požadavku
+
+double ServiceTime() {
+    return SERVICE_TIME * (1 + ALPHA * Exponential(MEAN_CONTAINER_LOAD));
+}
+
+class Completion : public Event {
+    void Behavior() {
+        free_completions.push_back(this);
+        CountOperation();
+    }
+public:
+    // Událost zůstává po Behavior() neaktivní, ale nesmí být zrušena
+    static Completion *Create() {
+        if (free_completions.empty())
+            return new Completion;
+        Completion *c = free_completions.back();
+        free_completions.pop_back();
+        return c;
+    }
+};
+
+double InterarrivalTime() {
+    int interval = ((int)(Time / SIMULATION_INTERVAL)) % 1440;
+    double rate = rate_scale * REQUESTS_MULTIPLIER * requests_per_minute[interval] / SIMULATION_INTERVAL;
+    return Exponential(1.0 / rate);
+}
+
+class Arrival : public Event {
+    void Behavior() {
+        if (CountOperation())
+            return;
+        Completion::Create()->Activate(Time + ServiceTime());
+        Activate(Time + InterarrivalTime());
+    }
+};
+
+void TraceModel(int pending) {
+    double mean_rate = 0;
+    for (int i = 0; i < 1440; i++)
+        mean_rate += REQUESTS_MULTIPLIER * requests_per_minute[i] / (double)SIMULATION_INTERVAL;
+    mean_rate /= 1440;
+    double mean_service = SERVICE_TIME * (1 + ALPHA * MEAN_CONTAINER_LOAD);
+    rate_scale = pending / (mean_rate * mean_service);  // Littleův zákon
+
+    // Ustálený stav: čekající dokončení se zbytkovou dobou zpracování
+    vector<double> times(pending);
+    for (double &t : times)
+        t = Uniform(0, 1) * ServiceTime();
+    sort(times.begin(), times.end());
+    for (double t : times)
+        Completion::Create()->Activate(t);
+    (new Arrival)->Activate();
+}
+
+
+/* SPUŠTĚNÍ JEDNOHO MĚŘENÍ */
+void Measure(const char *workload, void (*model)(int), const char *calendar, int pending) {
+    SetCalendar(calendar);
+    Init(0);
+    RandomSeed(1234);
+    model(pending);
+    StartMeasurement();
+    Run();
+
+    // Dokončení mimo kalendář nejsou SQS::Clear() zrušena
+    for (Completion *c : free_completions)
+        delete c;
+    free_completions.clear();
+
+    cout << workload << "," << calendar << "," << pending << "," << ops << ","
+         << (elapsed * 1e9 / ops) << ",";
+    if (misses >= 0)
+        cout << ((double)misses / ops);
+    cout << endl;
+}
+
+
+int main(int argc, char *argv[]) {
+    int max_pending = (argc > 1) ? atoi(argv[1]) : 1000000;
+
+    if (!cache_misses.Available())
+        cerr << "perf_event_open není dostupný, cache misses nebudou měřeny" << endl;
+
+    cout << "workload,calendar,pending,ops,ns_per_op,cache_misses_per_op" << endl;
+    for (int pending = 10; pending <= max_pending; pending *= 10) {
+        for (unsigned i = 0; CalendarName(i) != nullptr; i++) {
+            Measure("hold", HoldModel, CalendarName(i), pending);
+            Measure("trace", TraceModel, CalendarName(i), pending);
+        }
+    }
+    SetCalendar("default");
+    return 0;
+}
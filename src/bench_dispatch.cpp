@@ -0,0 +1,103 @@
+/*
+ *  Název programu: Benchmark výběru nejméně vytíženého kontejneru
+ *
+ *  Porovnává lineární průchod polem kontejnerů s indexovanou haldou
+ *  (LoadIndex) při 40, 1000 a 10000 připravených kontejnerech.
+ *  Výstup je CSV: kontejnery, metoda, počet událostí, čas [s], události/s.
+ *
+ *  Použití: ./bench_dispatch [počet_kontejnerů ...]
+ */
+
+#include <iostream>
+#include <vector>
+#include <chrono>
+#include <cstdlib>
+
+#include "simlib.h"
+#include "load_index.hpp"
+
+using namespace std;
+
+const double SERVICE_TIME = 0.1;          // Základní čas zpracování požadavku
+const double ALPHA = 0.02;                // Koeficient nárůstu latence
+const double LOAD_PER_CONTAINER = 4.0;    // Průměrný počet souběžných požadavků na kontejner
+const long REQUESTS = 1000000;            // Počet požadavků na jedno měření
+
+int n_containers = 0;
+bool use_index = false;
+vector<int> active_requests;
+LoadIndex ready_index;
+
+int SelectContainer() {
+    if (use_index)
+        return ready_index.Min();
+    int selected = -1;
+    for (int i = 0; i < n_containers; i++) {
+        if (selected < 0 || active_requests[i] < active_requests[selected])
+            selected = i;
+    }
+    return selected;
+}
+
+class Request : public Process {
+    void Behavior() {
+        int id = SelectContainer();
+        active_requests[id]++;
+        ready_index.Update(id, active_requests[id]);
+        Wait(SERVICE_TIME * (1 + ALPHA * active_requests[id]));
+        active_requests[id]--;
+        ready_index.Update(id, active_requests[id]);
+    }
+};
+
+class RequestGenerator : public Event {
+    double interarrival;
+public:
+    explicit RequestGenerator(double mean) : interarrival(mean) {}
+    void Behavior() {
+        (new Request)->Activate();
+        Activate(Time + Exponential(interarrival));
+    }
+};
+
+void RunBenchmark(int containers, bool index) {
+    n_containers = containers;
+    use_index = index;
+    active_requests.assign(containers, 0);
+    ready_index = LoadIndex(containers);
+    for (int i = 0; i < containers; i++)
+        ready_index.Insert(i, 0);
+
+    // Intenzita příchodů odpovídá zvolené průměrné zátěži kontejnerů
+    double rate = containers * LOAD_PER_CONTAINER / SERVICE_TIME;
+    Init(0, REQUESTS / rate);
+    RandomSeed(12345);
+    (new RequestGenerator(1.0 / rate))->Activate();
+
+    auto start = chrono::steady_clock::now();
+    Run();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    long events = SIMLIB_statistics.EventCount;
+    cout << containers << "," << (index ? "heap" : "scan") << ","
+         << events << "," << seconds << "," << (long)(events / seconds) << endl;
+}
+
+int main(int argc, char *argv[]) {
+    // Seznamový kalendář má vkládání O(n) a při tisících rozpracovaných
+    // požadavků by převážil měřený výběr kontejneru
+    SetCalendar("cq");
+
+    vector<int> sizes;
+    for (int i = 1; i < argc; i++)
+        sizes.push_back(atoi(argv[i]));
+    if (sizes.empty())
+        sizes = {40, 1000, 10000};
+
+    cout << "containers,method,events,seconds,events_per_second" << endl;
+    for (int n : sizes) {
+        RunBenchmark(n, false);
+        RunBenchmark(n, true);
+    }
+    return 0;
+}
@@ -0,0 +1,143 @@
+/*
+ *  Název programu: Benchmark přepínání procesů SIMLIB
+ *
+ *  Měří cenu přerušení a obnovení Process::Behavior() (Wait) pro implementace
+ *  procesů v simlib/src/process.cc volené při překladu:
+ *    - copy:     kopírování zásobníku na haldu (setjmp/longjmp)
+ *    - ucontext: samostatné zásobníky, přepínání přes swapcontext()
+ *    - asm:      samostatné zásobníky, přepínání v assembleru (x86-64)
+ *    - coroutine: CoProcess z coprocess.h (C++20 korutiny, -DCOROUTINE_BACKEND)
+ *  Implementace se vybírá přeložením process.cc přímo do programu
+ *  (viz Makefile, cíle bench_process_*), zbytek knihovny je společný.
+ *
+ *  Každý proces opakovaně čeká Wait(1); před čekáním má na zásobníku
+ *  stack_bytes bajtů lokálních dat (cena kopírování roste s jejich velikostí).
+ *  Korutina nemá zásobník, který by se kopíroval - lokální data (stack_bytes)
+ *  leží v rámci korutiny. Měří se celá operace (plánování v kalendáři
+ *  a přepnutí): základ s událostmi by měl jinou populaci a zátěž kalendáře,
+ *  takže rozdíl oproti němu by cenu samotného přepnutí neurčil.
+ *
+ *  Výstup je CSV: backend, processes, stack_bytes, switches, ns_per_switch
+ *
+ *  Použití: ./bench_process_<backend> [max_processes]
+ */
+
+#include <iostream>
+#include <chrono>
+#include <cstdlib>
+
+#include "simlib.h"
+#ifdef COROUTINE_BACKEND
+#include "coprocess.h"
+#endif
+
+#ifndef BACKEND
+#define BACKEND "default"
+#endif
+
+using namespace std;
+
+const long MAX_OPS = 2000000;           // Maximální počet přepnutí na jedno měření
+const double TIME_BUDGET = 1.0;         // Časový limit jednoho měření v sekundách
+const int PAD = 256;                    // Velikost lokálních dat jedné úrovně rekurze
+
+
+/* MĚŘENÍ JEDNOHO BĚHU */
+chrono::steady_clock::time_point start_time;
+long ops = 0;
+double elapsed = 0;
+
+// Provede se po každém přepnutí, vrací true, pokud má měření skončit
+bool CountOperation() {
+    ++ops;
+    if (ops >= MAX_OPS || ((ops & 1023) == 0 &&
+            chrono::duration<double>(chrono::steady_clock::now() - start_time).count() > TIME_BUDGET)) {
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start_time).count();
+        Stop();
+        return true;
+    }
+    return false;
+}
+
+
+#ifndef COROUTINE_BACKEND
+/* PROCES S LOKÁLNÍMI DATY NA ZÁSOBNÍKU */
+class Worker : public Process {
+    int stack_bytes;
+
+    // Rekurze drží na zásobníku stack_bytes bajtů po dobu čekání
+    void Body(int bytes) {
+        volatile char pad[PAD];
+        pad[0] = (char)bytes;
+        if (bytes > PAD) {
+            Body(bytes - PAD);
+            pad[0] = 0;     // zabrání optimalizaci koncového volání
+            return;
+        }
+        for (;;) {
+            Wait(1);
+            if (CountOperation())
+                return;
+        }
+        (void)pad[0];
+    }
+public:
+    Worker(int bytes) : stack_bytes(bytes) {}
+    void Behavior() {
+        Body(stack_bytes);
+        Passivate();    // proces zůstane v paměti do konce běhu
+    }
+};
+#endif
+
+
+#ifdef COROUTINE_BACKEND
+/* KORUTINA S LOKÁLNÍMI DATY V RÁMCI */
+class CoWorker : public CoProcess {
+    int stack_bytes;
+public:
+    CoWorker(int bytes) : stack_bytes(bytes) {}
+    CoBehavior Behavior() override {
+        volatile char pad[8192];
+        for (int i = 0; i < stack_bytes; i += PAD)
+            pad[i] = (char)i;
+        for (;;) {
+            co_await Wait(1);
+            if (CountOperation())
+                break;
+        }
+        (void)pad[0];
+        co_await Passivate();   // proces zůstane v paměti do konce běhu
+    }
+};
+typedef CoWorker Worker;
+#endif
+
+
+// Vrací dobu jedné operace v ns
+double Measure(int processes, int stack_bytes) {
+    Init(0);
+    for (int i = 0; i < processes; i++)
+        (new Worker(stack_bytes))->Activate((double)i / processes);
+    ops = 0;
+    start_time = chrono::steady_clock::now();
+    Run();
+    return elapsed * 1e9 / ops;
+}
+
+
+int main(int argc, char *argv[]) {
+    int max_processes = (argc > 1) ? atoi(argv[1]) : 10000;
+
+    SetCalendar("heap");
+    cout << "backend,processes,stack_bytes,switches,ns_per_switch" << endl;
+    for (int processes = 1; processes <= max_processes; processes *= 10) {
+        for (int stack_bytes : {0, 1024, 8192}) {
+            double ns = Measure(processes, stack_bytes);
+            cout << BACKEND << "," << processes << "," << stack_bytes << ","
+                 << ops << "," << ns << endl;
+        }
+    }
+    SetCalendar("default");
+    return 0;
+}
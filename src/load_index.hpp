@@ -0,0 +1,127 @@
+/*
+ *  Název: Index zátěže kontejnerů pro výběr nejméně vytíženého kontejneru
+ *
+ *  Indexovaná binární min-halda nad identifikátory kontejnerů.
+ *  Klíčem je dvojice (počet aktivních požadavků, id), takže při shodné zátěži
+ *  vyhrává kontejner s nejnižším id - stejně jako původní lineární průchod.
+ *
+ *  Operace:  Min()                 O(1)
+ *            Insert/Remove/Update  O(log n)
+ */
+
+#ifndef LOAD_INDEX_HPP
+#define LOAD_INDEX_HPP
+
+#include <vector>
+
+class LoadIndex {
+public:
+    explicit LoadIndex(int capacity = 0) { Reserve(capacity); }
+
+    // Zvětší index tak, aby pojal kontejnery s id < capacity
+    void Reserve(int capacity) {
+        if (capacity > (int)pos.size()) {
+            pos.resize(capacity, -1);
+            key.resize(capacity, 0);
+        }
+    }
+
+    bool Empty() const { return heap.empty(); }
+    int Size() const { return (int)heap.size(); }
+    bool Contains(int id) const { return id < (int)pos.size() && pos[id] >= 0; }
+
+    // Id kontejneru s nejnižší zátěží, -1 pokud není žádný připravený kontejner
+    int Min() const { return heap.empty() ? -1 : heap[0]; }
+
+    // Vloží kontejner do indexu (kontejner je připraven přijímat požadavky)
+    void Insert(int id, int load) {
+        if (Contains(id)) {
+            Update(id, load);
+            return;
+        }
+        Reserve(id + 1);
+        key[id] = load;
+        pos[id] = (int)heap.size();
+        heap.push_back(id);
+        SiftUp(pos[id]);
+    }
+
+    // Odebere kontejner z indexu (deaktivace, restart)
+    void Remove(int id) {
+        if (!Contains(id))
+            return;
+        int i = pos[id];
+        int last = heap.back();
+        heap.pop_back();
+        pos[id] = -1;
+        if (last != id) {
+            heap[i] = last;
+            pos[last] = i;
+            SiftDown(i);
+            SiftUp(pos[last]);
+        }
+    }
+
+    // Změna zátěže kontejneru, který je v indexu
+    void Update(int id, int load) {
+        if (!Contains(id))
+            return;
+        int old = key[id];
+        key[id] = load;
+        if (load < old)
+            SiftUp(pos[id]);
+        else if (load > old)
+            SiftDown(pos[id]);
+    }
+
+    void Clear() {
+        for (int id : heap)
+            pos[id] = -1;
+        heap.clear();
+    }
+
+private:
+    std::vector<int> heap;  // halda identifikátorů kontejnerů
+    std::vector<int> pos;   // pozice kontejneru v haldě (-1 = není v indexu)
+    std::vector<int> key;   // zátěž kontejneru v okamžiku poslední změny
+
+    bool Less(int a, int b) const {
+        return key[a] < key[b] || (key[a] == key[b] && a < b);
+    }
+
+    void Place(int i, int id) {
+        heap[i] = id;
+        pos[id] = i;
+    }
+
+    void SiftUp(int i) {
+        int id = heap[i];
+        while (i > 0) {
+            int parent = (i - 1) / 2;
+            if (!Less(id, heap[parent]))
+                break;
+            Place(i, heap[parent]);
+            i = parent;
+        }
+        Place(i, id);
+    }
+
+    void SiftDown(int i) {
+        int n = (int)heap.size();
+        int id = heap[i];
+        for (;;) {
+            int child = 2 * i + 1;
+            if (child >= n)
+                break;
+            if (child + 1 < n && Less(heap[child + 1], heap[child]))
+                child++;
+            if (!Less(heap[child], id))
+                break;
+            Place(i, heap[child]);
+            i = child;
+        }
+        Place(i, id);
+    }
+};
+
+#endif // LOAD_INDEX_HPP
@@ -11,10 +11,24 @@
 #include <iomanip>
 #include <cmath>
 #include <vector>
-#include <limits>
+#include <algorithm>
+#include <cstdlib>
+#include <ctime>
+#include <chrono>
+#include <sstream>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <functional>
+#include <mutex>
+#include <thread>
 
 #include "simlib.h"
 #include "dataset.hpp"
+#include "load_index.hpp"
+#include "metrics.hpp"
+#include "slot_set.hpp"
+#include "trace.hpp"
 
 using namespace std;
 
@@ -49,7 +63,7 @@ const int CONTAINER_STARTUP_TIME = 15;         // Doba spuštění kontejneru v
 
 
 /* KONSTANTY */
-const int SIMULATION_TIME = 24 * 3600;         // Simulujeme 24 hodin (v sekundách)
+const int SIMULATION_TIME = 24 * 3600;         // Simulujeme 24 hodin (v sekundách), s trace jeho délku
 const int SIMULATION_INTERVAL = 60;            // Simulujeme zátěž po minutových intervalech (v sekundách)
 
 // Predictive - Výpočet DESIRED_LOAD - maximální průměrný počet současně se vyřizujících požadavků v jednom kontejneru
@@ -60,131 +74,447 @@ const int SCALE_DOWN_LOAD = (SCALE_DOWN_LOAD_PERCENTAGE * (SLA_RESPONSE_TIME - S
 
 
 /* GLOBÁLNÍ PROMĚNNÉ */
-int total_containers = 0;
-int max_containers_created = 0;
-int sla_violations = 0;
-long total_requests = 0;
-double operating_cost = 0.0;
+// Stav modelu je thread_local nebo součástí Cluster: replikace běží souběžně
+// ve více vláknech (viz RunReplications), každé vlákno simuluje svou kopii modelu
+
+bool verbose = true;                           // Výpis průběhu simulace (při replikacích vypnut)
+bool fluid_engine = false;                     // Fluidní model místo simulace po požadavcích (-E fluid)
+double simulation_time = SIMULATION_TIME;      // Délka simulace v sekundách (-H, délka trace)
+string trace_path;                             // Trace zátěže (-t), prázdný = vestavěný dataset.hpp
+string calendar_name = "default";              // Implementace kalendáře SIMLIB (-k)
+string replay_path;                            // Trace jednotlivých požadavků (-R), prázdný = generované příchody
+ostream* load_series_out = nullptr;            // Časová řada zátěže kontejnerů (-L), jen při jednom běhu
+string metrics_path;                           // Sloupcový soubor metrik clusterů (-M), jen při jednom běhu
+string metrics_csv_path;                       // Tytéž metriky jako CSV (-C)
+double metrics_interval = SIMULATION_INTERVAL; // Perioda vzorkování metrik v sekundách (-I)
+
+
+/* ZDROJ ZÁTĚŽE */
+// Trace se čte proudově: každý běh si ho namapuje sám (viz RunSimulation),
+// paměť tak nezávisí na délce trace ani na počtu vláken
+thread_local TraceReader* workload_trace = nullptr;
+thread_local RequestTraceReader* replay_trace = nullptr;    // Přehrávané požadavky (-R)
+thread_local uint64_t replay_counted = 0;                   // Požadavky v intervalech před LoadWindow::end
+
+const int DATASET_INTERVALS = sizeof(requests_per_minute) / sizeof(requests_per_minute[0]);
+
+// Průměrný počet požadavků v intervalu (index od začátku simulace, zátěž se
+// po konci dat opakuje); záznamy kratšího trace se sečtou do intervalu
+int WorkloadRequests(long interval) {
+    if (workload_trace == nullptr)
+        return requests_per_minute[interval % DATASET_INTERVALS];
+    int records = SIMULATION_INTERVAL / workload_trace->Interval();
+    return (int)workload_trace->Sum((uint64_t)interval * records, records);
+}
+
+// Predikovaný počet požadavků v intervalu; při přehrávání je predikce
+// přesná (počet zaznamenaných příchodů v intervalu)
+int PredictedRequests(long interval) {
+    if (replay_trace == nullptr)
+        return REQUESTS_MULTIPLIER * WorkloadRequests(interval);
+    uint64_t first = replay_counted;
+    replay_counted = replay_trace->Seek((interval + 1.0) * SIMULATION_INTERVAL, first);
+    return (int)(replay_counted - first);
+}
+
+
+/* NÁHODNÉ PROUDY */
+// Model losuje z xoshiro256++ (perioda 2^256-1): LCG SIMLIB má periodu jen
+// 2^29 a 24h běh spotřebuje asi 4e7 čísel, replikace by se tedy překrývaly.
+// Příchody a odchylka zátěže mají vlastní pojmenované proudy, změna jednoho
+// neposune druhý. Doba zpracování je deterministická (SERVICE_TIME a zátěž),
+// proud pro ni není potřeba.
+thread_local RandomStream arrival_stream("arrivals");
+thread_local RandomStream load_stream("load deviation");
+
+// Losování v bloku z daného proudu (Random() i rozdělení SIMLIB)
+class StreamScope {
+    RandomStream* previous;
+public:
+    explicit StreamScope(RandomStream& stream) : previous(SetRandomStream(&stream)) {}
+    ~StreamScope() { SetRandomStream(previous); }
+};
+
+// Generátor a seed běhu; replikace r má nezávislé stavy všech proudů
+void SeedStreams(long seed, unsigned long replication) {
+    SetBaseRandomGenerator(RandomXoshiro256);
+    RandomSeed(seed, replication);
+}
+
+
+/* OKNO ZÁTĚŽE */
+// Predikovaná a reálná zátěž se počítá až pro intervaly, které model
+// potřebuje (aktuální interval a horizont prediktivního autoscaleru),
+// a drží se jen posledních WINDOW intervalů
+class LoadWindow {
+    static const int WINDOW = 64;
+    int predicted[WINDOW];
+    int real[WINDOW];
+    long end = 0;           // Spočtené intervaly: end - WINDOW .. end - 1
+
+    // Dopočítá intervaly až po interval včetně
+    void Extend(long interval) {
+        if (interval < end - WINDOW) {
+            cerr << "Interval " << interval << " už není v okně zátěže" << endl;
+            exit(1);
+        }
+        for (; end <= interval; end++) {
+            int mean = PredictedRequests(end);
+            predicted[end % WINDOW] = mean;
+            if (replay_trace != nullptr) {
+                real[end % WINDOW] = mean;      // Přehrávání nelosuje
+                continue;
+            }
+            // Generování reálné zátěže s normálním rozdělením kolem predikce
+            double deviation = STANDARD_DEVIATION * mean;
+            StreamScope scope(load_stream);
+            double real_requests = Normal(mean, deviation);
+            // Zaokrouhlení na celé číslo a omezení na nezáporné hodnoty
+            real[end % WINDOW] = static_cast<int>(max(0.0, real_requests));
+        }
+    }
+public:
+    void Clear() { end = 0; }
+
+    // Predikovaný počet požadavků v intervalu
+    int Predicted(long interval) {
+        Extend(interval);
+        return predicted[interval % WINDOW];
+    }
 
+    // Reálný počet požadavků v intervalu
+    int Real(long interval) {
+        Extend(interval);
+        return real[interval % WINDOW];
+    }
+};
 
-/* PREDIKTIVNÍ ŠKÁLOVÁNÍ */
-vector<int> predicted_load((SIMULATION_TIME / SIMULATION_INTERVAL), 0);
+thread_local LoadWindow load_window;
 
-/* REÁLNÁ ZÁTĚŽ */
-vector<int> real_requests_per_minute((SIMULATION_TIME / SIMULATION_INTERVAL), 0);
+/* ZDROJ ZÁTĚŽE JEDNOHO BĚHU */
+// Namapuje trace (-t, -R) pro běh v aktuálním vlákně a vyprázdní okno zátěže
+struct WorkloadSource {
+    TraceReader trace;
+    RequestTraceReader replay;
+
+    WorkloadSource() {
+        if (!trace_path.empty()) {
+            if (!trace.Open(trace_path)) {
+                cerr << trace.Error() << endl;
+                exit(1);
+            }
+            workload_trace = &trace;
+        }
+        if (!replay_path.empty()) {
+            if (!replay.Open(replay_path)) {
+                cerr << replay.Error() << endl;
+                exit(1);
+            }
+            replay_trace = &replay;
+            replay_counted = 0;
+        }
+        load_window.Clear();
+    }
 
-/* STATISTIKY */
-Stat response_time_stat("Doba odezvy");
-Histogram response_time_hist("Histogram doby odezvy", 0, 0.05, 20);
+    ~WorkloadSource() {
+        workload_trace = nullptr;
+        replay_trace = nullptr;
+    }
+};
 
 /* POMOCNÁ FUNKCE */
 string PrintTime(int timeInSeconds);
 
 
-/* Před deklarací třídy Container deklarujeme pole containers */
-class Container; // Předběžná deklarace třídy
-Container* containers[MAX_CONTAINERS];    // Pole kontejnerů
+/* STAV CLUSTERU PRO AUTOSCALER */
+// Počty kontejnerů a zátěž připravených kontejnerů udržují kontejnery
+// průběžně při každé změně stavu (Container::SetState), autoscaler tedy při
+// rozhodování kontejnery neprochází. Zbytek doplní Cluster::Snapshot().
+struct ClusterSnapshot {
+    double time = 0.0;          // Čas rozhodnutí
+    int ready = 0;              // Připravené kontejnery (aktivní a spuštěné)
+    int starting = 0;           // Kontejnery ve spouštění
+    int total = 0;              // Aktivní kontejnery clusteru
+    double load = 0.0;          // Součet zátěže připravených kontejnerů
+    double average_load = 0.0;  // Průměrná zátěž připraveného kontejneru
+    double arrival_rate = 0.0;  // Příchody za sekundu od minulého rozhodnutí
+};
+
+
+/* ČASOVĚ VÁŽENÁ ZÁTĚŽ */
+// Souhrn zátěže kontejneru za jeden interval SIMULATION_INTERVAL: integrál
+// počtu aktivních požadavků přes čas (průměr = integrál / délka intervalu)
+// a maximum. Kontejner při změně zátěže jen přičte obdélník od poslední
+// změny, souhrny se uzavírají na hranicích intervalů (LoadRollup).
+struct LoadSample {
+    float integral;           // Požadavko-sekundy v intervalu
+    int32_t max;              // Maximální počet současných požadavků
+};
 
 
 /* TŘÍDA KONTEJNERU */
 class Container {
+    LoadIndex& ready_index;   // Připravené kontejnery clusteru
+    ClusterSnapshot& state;   // Průběžně udržovaný stav clusteru
+    SlotSet& active_slots;    // Aktivní kontejnery clusteru
+
+    // Změní stav kontejneru a promítne ho do počtů a zátěže clusteru
+    void SetState(bool active, bool ready) {
+        bool was_ready = is_active && is_ready;
+        bool was_starting = is_active && !is_ready;
+        if (active != is_active) {
+            if (active)
+                active_slots.Set(id);
+            else
+                active_slots.Clear(id);
+        }
+        is_active = active;
+        is_ready = ready;
+        bool now_ready = is_active && is_ready;
+        state.ready += now_ready - was_ready;
+        state.starting += (is_active && !is_ready) - was_starting;
+        if (now_ready != was_ready)
+            state.load += now_ready ? active_requests : -active_requests;
+    }
 public:
     int id;                   // Identifikátor kontejneru
     int active_requests;      // Počet aktivních požadavků
     double load;              // Zátěž kontejneru (počet aktivních požadavků)
-    Stat* load_stat;          // Statistika zátěže
+    double load_integral;     // Integrál zátěže v aktuálním intervalu
+    double last_change;       // Čas poslední změny zátěže (nebo uzavření intervalu)
+    int load_max;             // Maximum zátěže v aktuálním intervalu
+    double total_load_integral;     // Integrál zátěže uzavřených intervalů
+    double creation_time;           // Čas vytvoření kontejneru
+    long first_interval;            // Interval vytvoření kontejneru (první prvek load_series)
+    vector<LoadSample> load_series; // Souhrny uzavřených intervalů
     double activation_time;   // Čas aktivace kontejneru
     double total_active_time; // Celkový čas, po který byl kontejner aktivní
     bool is_active;           // Indikátor, zda je kontejner aktivní
     bool is_ready;            // Indikátor, zda je kontejner připraven přijímat požadavky
 
-    Container(int id) : id(id), active_requests(0), load(0.0), total_active_time(0.0), is_active(false), is_ready(false) {
+    Container(LoadIndex& ready_index, ClusterSnapshot& state, SlotSet& active_slots, int id)
+        : ready_index(ready_index), state(state), active_slots(active_slots), id(id), active_requests(0), load(0.0),
+          load_integral(0.0), last_change(Time), load_max(0), total_load_integral(0.0),
+          creation_time(Time), first_interval((long)(Time / SIMULATION_INTERVAL)), total_active_time(0.0), is_active(false), is_ready(false) {
         activation_time = Time;
-        load_stat = new Stat();
     }
 
     // Přijme požadavek
     void AcceptRequest() {
+        AdvanceLoad();
         active_requests++;
-        UpdateLoad();
+        if (is_active && is_ready)
+            state.load++;
+        load = active_requests;
+        if (active_requests > load_max)
+            load_max = active_requests;
+        ready_index.Update(id, active_requests);
     }
 
     // Uvolní požadavek po zpracování
     void ReleaseRequest() {
+        AdvanceLoad();
         active_requests--;
-        UpdateLoad();
+        if (is_active && is_ready)
+            state.load--;
+        load = active_requests;
+        ready_index.Update(id, active_requests);
     }
 
-    // Aktualizuje zátěž kontejneru
-    void UpdateLoad() {
-        load = active_requests;
-        (*load_stat)(load);
+    // Přičte zátěž od poslední změny do aktuálního času
+    void AdvanceLoad() {
+        load_integral += active_requests * (Time - last_change);
+        last_change = Time;
+    }
+
+    // Začátek otevřeného intervalu (za posledním souhrnem v load_series)
+    double OpenIntervalStart() const {
+        return (double)(first_interval + (long)load_series.size()) * SIMULATION_INTERVAL;
+    }
+
+    // Uzavře interval končící v čase end do load_series
+    void RollupLoad(double end) {
+        load_integral += active_requests * (end - last_change);
+        last_change = end;
+        load_series.push_back({(float)load_integral, load_max});
+        total_load_integral += load_integral;
+        load_integral = 0.0;
+        load_max = active_requests;
+    }
+
+    // Maximální zátěž od vytvoření kontejneru
+    int MaxLoad() const {
+        int result = load_max;
+        for (const LoadSample& sample : load_series)
+            result = max(result, (int)sample.max);
+        return result;
+    }
+
+    // Časově vážená zátěž od vytvoření kontejneru
+    double MeanLoad() const {
+        double integral = total_load_integral + load_integral + active_requests * (Time - last_change);
+        return (Time > creation_time) ? integral / (Time - creation_time) : 0.0;
     }
 
     // Deaktivuje kontejner
     void Deactivate() {
         if (is_active) {
-            is_active = false;
+            SetState(false, is_ready);
             total_active_time += Time - activation_time;
         }
+        ready_index.Remove(id);
     }
 
     // Aktivuje kontejner
     void Activate() {
         if (!is_active) {
-            is_active = true; // Kontejner bude aktivní po době spuštění
-            is_ready = false;
+            SetState(true, false); // Kontejner bude připraven po době spuštění
             activation_time = Time;
+            ready_index.Remove(id);
         }
     }
 
     // Spustí kontejner po době spuštění
     void Start() {
-        is_active = true;
-        is_ready = true;
+        SetState(true, true);
         activation_time = Time;
+        ready_index.Insert(id, active_requests);
+    }
+};
+
+struct ReplicationResult;
+
+
+/* ŠKÁLOVACÍ POLITIKY */
+// Autoscaler clusteru se každých SCALING_INTERVAL minut zeptá své politiky na
+// změnu počtu kontejnerů (Autoscaler, RunFluid). Politika vidí jen
+// ClusterSnapshot, nový způsob škálování je tedy jen nová třída
+// zaregistrovaná pod svým názvem (RegisterPolicy), bez zásahu do simulace.
+class AutoscalerPolicy {
+public:
+    virtual ~AutoscalerPolicy() {}
+
+    // Název ve výpisech průběhu ("Reaktivní" škálování nahoru ...)
+    virtual const char* Label() const = 0;
+
+    // Změna počtu kontejnerů: kladná = přidat, záporná = odebrat. Když politika
+    // škálování odloží, může do note (je-li zadána) zapsat důvod pro výpis.
+    virtual int Decide(const ClusterSnapshot& cluster, string* note) = 0;
+};
+
+typedef function<AutoscalerPolicy*()> PolicyFactory;
+
+// Politiky podle názvu (-m); plní se při statické inicializaci, pak se jen čte
+map<string, PolicyFactory>& PolicyRegistry() {
+    static map<string, PolicyFactory> registry;
+    return registry;
+}
+
+struct RegisterPolicy {
+    RegisterPolicy(const string& name, PolicyFactory factory) {
+        PolicyRegistry()[name] = factory;
+    }
+};
+
+// Nová instance politiky (každý cluster má vlastní, politika může mít stav)
+unique_ptr<AutoscalerPolicy> CreatePolicy(const string& name) {
+    auto it = PolicyRegistry().find(name);
+    return unique_ptr<AutoscalerPolicy>((it != PolicyRegistry().end()) ? it->second() : nullptr);
+}
+
+
+/* CLUSTER */
+// Kontejnery, fronta a statistiky jednoho clusteru řízeného jedním
+// autoscalerem. Při stínovém vyhodnocení (-P shadow) běží v jedné simulaci
+// několik clusterů a všechny dostávají tytéž příchody (SpawnRequests).
+struct Cluster {
+    string scaling_model;                   // Název politiky autoscaleru
+    unique_ptr<AutoscalerPolicy> policy;    // Politika autoscaleru clusteru
+    string prefix;                          // Předpona výpisů průběhu
+    Container* containers[MAX_CONTAINERS];  // Pole kontejnerů
+    int total_containers = 0;
+    int max_containers_created = 0;
+    int sla_violations = 0;
+    long total_requests = 0;
+    LoadIndex ready_index;                  // Připravené kontejnery seřazené podle zátěže
+    Queue waiting_requests;                 // Požadavky čekající na připravený kontejner
+    Stat response_time_stat;
+    Histogram response_time_hist;
+    QuantileHistogram response_time_quantiles;  // Percentily doby odezvy (SLA je na 95. percentil)
+    ClusterSnapshot state;                  // Průběžně udržovaný stav pro autoscaler
+    SlotSet active_slots;                   // Aktivní kontejnery (výběr pozice při škálování)
+    long arrivals = 0;                      // Příchody od minulého rozhodnutí
+    long total_arrivals = 0;                // Všechny příchody (metriky)
+    double last_decision = 0.0;             // Čas minulého rozhodnutí
+
+    Cluster(const string& scaling_model)
+        : scaling_model(scaling_model), policy(CreatePolicy(scaling_model)), ready_index(MAX_CONTAINERS), waiting_requests("Čekající požadavky"),
+          response_time_stat("Doba odezvy"), response_time_hist("Histogram doby odezvy", 0, 0.05, 20),
+          response_time_quantiles("Kvantily doby odezvy", 1e-3, 1e3, 7),
+          active_slots(MAX_CONTAINERS) {
+        for (int i = 0; i < MAX_CONTAINERS; i++) {
+            containers[i] = nullptr;
+        }
     }
+    ~Cluster();
+
+    ostream& Log() { return cout << prefix; }
+    const ClusterSnapshot& Snapshot();
+    void InitContainers(int count);
+    void AddContainer();
+    void RemoveContainer();
+    void WakeWaitingRequests();
+    ReplicationResult Results();
 };
 
+thread_local vector<Cluster*> clusters;    // Clustery běžící simulace
+
+
 /* PROCES SPUŠTĚNÍ KONTEJNERU */
 class ContainerStartup : public Event {
 public:
+    Cluster* cluster;
     Container* container;
 
-    ContainerStartup(Container* c) : container(c) {}
+    ContainerStartup(Cluster* cluster, Container* c) : cluster(cluster), container(c) {}
 
     void Behavior() {
         container->Start();
-        cout << "Kontejner " << container->id << " je připraven v čase " << PrintTime(Time) << endl;
+        cluster->WakeWaitingRequests();
+        if (verbose)
+            cluster->Log() << "Kontejner " << container->id << " je připraven v čase " << PrintTime(Time) << endl;
     }
 };
 
 
 /* TŘÍDA POŽADAVKU */
+void ScheduleNextArrival();
+
 class Request : public Process {
+    Cluster* cluster;         // Cluster, který požadavek zpracuje
+    double service_demand;    // Doba zpracování bez zátěže (v sekundách)
+    bool first;               // Požadavek prvního clusteru plánuje další příchod
 public:
+    Request(Cluster* cluster, double service_demand, bool first)
+        : cluster(cluster), service_demand(service_demand), first(first) {}
+
     void Behavior() {
         double arrival_time = Time;
+        if (first)
+            ScheduleNextArrival();
         bool assigned = false;
 
         while (!assigned) {
-            // Najdeme kontejner s nejnižší zátěží
-            double min_load = std::numeric_limits<double>::max();
-            Container* selected_container = nullptr;
-
-            for (int i = 0; i < max_containers_created; i++) {
-                if (containers[i]->is_active && containers[i]->is_ready && containers[i]->load < min_load) {
-                    min_load = containers[i]->load;
-                    selected_container = containers[i];
-                }
-            }
+            // Najdeme kontejner s nejnižší zátěží (vrchol haldy připravených kontejnerů)
+            int selected_id = cluster->ready_index.Min();
+            Container* selected_container = (selected_id >= 0) ? cluster->containers[selected_id] : nullptr;
 
             if (selected_container != nullptr) {
                 // Přijmeme požadavek do vybraného kontejneru
                 selected_container->AcceptRequest();
 
                 // Výpočet doby zpracování na základě zátěže
-                double processing_time = SERVICE_TIME * (1 + ALPHA * selected_container->load);
+                double processing_time = service_demand * (1 + ALPHA * selected_container->load);
 
                 // Simulace zpracování požadavku
                 Wait(processing_time);
@@ -193,111 +523,192 @@ public:
 
                 // Zaznamenáme statistiky
                 double response_time = Time - arrival_time;
-                response_time_stat(response_time);
-                response_time_hist(response_time);
+                cluster->response_time_stat(response_time);
+                cluster->response_time_hist(response_time);
+                cluster->response_time_quantiles(response_time);
                 if (response_time > SLA_RESPONSE_TIME) {
-                    sla_violations++;
+                    cluster->sla_violations++;
                 }
 
-                total_requests++;
+                cluster->total_requests++;
 
                 assigned = true;
             } else {
-                // Pokud žádný kontejner není dostupný, počkáme a zkusíme znovu
-                Wait(0.01);
+                // Pokud žádný kontejner není dostupný, uspíme se ve frontě,
+                // dokud nás nevzbudí spuštění kontejneru
+                Into(cluster->waiting_requests);
+                Passivate();
             }
         }
     }
 };
 
+/* PROBUZENÍ ČEKAJÍCÍCH POŽADAVKŮ */
+// Požadavky se aktivují v pořadí příchodu a ve stejném pořadí si vyberou kontejner.
+// Bez limitu souběžných požadavků na kontejner budíme celou frontu najednou.
+void Cluster::WakeWaitingRequests() {
+    while (!waiting_requests.Empty()) {
+        waiting_requests.GetFirst()->Activate();
+    }
+}
+
+/* PŘÍCHOD POŽADAVKU */
+// Jeden příchod vytvoří požadavek v každém clusteru (společná náhodná čísla)
+void SpawnRequests(double time, double service_demand = SERVICE_TIME) {
+    for (size_t i = 0; i < clusters.size(); i++) {
+        clusters[i]->arrivals++;
+        clusters[i]->total_arrivals++;
+        (new Request(clusters[i], service_demand, i == 0))->Activate(time);
+    }
+}
+
 
 /* FUNKCE PRO GENEROVÁNÍ INTERVALU MEZI PŘÍCHODY POŽADAVKŮ */
 double GetInterarrivalTime() {
-    int current_interval = ((int)(Time / SIMULATION_INTERVAL)) % (SIMULATION_TIME / SIMULATION_INTERVAL);
-    int requests_in_interval = real_requests_per_minute[current_interval];
+    long current_interval = (long)(Time / SIMULATION_INTERVAL);
+    int requests_in_interval = load_window.Real(current_interval);
     double interarrival_time = SIMULATION_INTERVAL * 1.0 / requests_in_interval;
+    StreamScope scope(arrival_stream);
     return Exponential(interarrival_time);
 }
 
-/* FUNKCE PRO GENEROVÁNÍ REÁLNÉ ZÁTĚŽE */
-void GenerateRealRequestsPerMinute() {
-    for (int i = 0; i < (SIMULATION_TIME / SIMULATION_INTERVAL); i++) {
-
-        // Generování reálné zátěže s normálním rozdělením
-        int mean = REQUESTS_MULTIPLIER * requests_per_minute[i];
-
-        // odchylka od průměrné hodnoty
-        double deviation = STANDARD_DEVIATION * mean;
-
-        // Vygenerování náhodného počtu požadavků
-        double real_requests = Normal(mean, deviation);
+/* GENERÁTOR POŽADAVKŮ */
+// Původní generátor: jedna událost a jedno losování na každý požadavek
+class RequestGenerator : public Event {
+    void Behavior() {
+        SpawnRequests(Time);
+        Activate(Time + GetInterarrivalTime());
+    }
+};
 
-        // Zaokrouhlení na celé číslo a omezení na nezáporné hodnoty
-        real_requests_per_minute[i] = static_cast<int>(max(0.0,real_requests));
+/* FUNKCE PRO HROMADNÉ GENEROVÁNÍ PŘÍCHODŮ V INTERVALU */
+// Počet příchodů v intervalu má Poissonovo rozdělení se střední hodnotou
+// reálné zátěže intervalu, jejich časy jsou seřazené rovnoměrně rozdělené
+// body intervalu: normované částečné součty n+1 exponenciálních mezer
+// (bez řazení). Odpovídá Poissonovu procesu s intenzitou konstantní v intervalu.
+void SampleIntervalArrivals(int interval_start, vector<double>& arrivals) {
+    int requests_in_interval = load_window.Real(interval_start / SIMULATION_INTERVAL);
+    StreamScope scope(arrival_stream);
+    int count = (requests_in_interval > 0) ? Poisson(requests_in_interval) : 0;
+
+    arrivals.resize(count + 1);
+    RandomFill(arrivals.data(), count + 1);
+    double sum = 0.0;
+    for (int i = 0; i <= count; i++) {
+        sum -= log(1.0 - arrivals[i]);   // Exponenciální mezera se střední hodnotou 1
+        arrivals[i] = sum;
     }
-    predicted_load[((SIMULATION_TIME / SIMULATION_INTERVAL) - 1)] = REQUESTS_MULTIPLIER * requests_per_minute[0]; // Poslední interval
+    double scale = SIMULATION_INTERVAL / sum;
+    arrivals.pop_back();
+    for (double& t : arrivals)
+        t = interval_start + t * scale;
 }
 
-/* FUNKCE PRO GENEROVÁNÍ PREDIKOVANÉ ZÁTĚŽE */
-void GeneratePredictedLoad() {
-    for (int i = 0; i < (SIMULATION_TIME / SIMULATION_INTERVAL); i++) {
-        predicted_load[i] =  REQUESTS_MULTIPLIER * requests_per_minute[i];
+/* ŘETĚZENÉ PŘÍCHODY */
+// Generátor, který má v kalendáři vždy jen následující požadavek;
+// požadavek si při svém startu řekne o další (ScheduleNextArrival)
+class ArrivalGenerator : public Event {
+public:
+    virtual void ScheduleNext() = 0;
+};
+
+/* HROMADNÝ GENERÁTOR POŽADAVKŮ */
+// Na začátku každého intervalu vylosuje všechny příchody najednou. Požadavky
+// se plánují rovnou na čas svého příchodu, vždy jen ten následující: každý
+// požadavek při svém startu naplánuje další (ScheduleNextArrival), generátor
+// se probouzí jen na hranicích intervalů. Na jeden požadavek tak nepřipadá
+// žádná událost generátoru, losování ani výpočet intervalu.
+class BatchRequestGenerator : public ArrivalGenerator {
+    vector<double> arrivals;   // Seřazené časy příchodů v aktuálním intervalu
+    size_t next = 0;           // Index dalšího příchodu
+    int interval_start = 0;    // Začátek aktuálního intervalu (v sekundách)
+
+    // Hranice intervalu: vylosujeme příchody celého intervalu
+    void Behavior() {
+        interval_start = (int)Time;
+        SampleIntervalArrivals(interval_start, arrivals);
+        next = 0;
+        ScheduleNext();
     }
-}
+public:
+    // Naplánuje další požadavek, po posledním příchodu sebe na konec intervalu
+    void ScheduleNext() override {
+        if (next < arrivals.size())
+            SpawnRequests(arrivals[next++]);
+        else
+            Activate(interval_start + SIMULATION_INTERVAL);
+    }
+};
 
+/* PŘEHRÁVÁNÍ ZAZNAMENANÝCH POŽADAVKŮ */
+// Požadavky vznikají v zaznamenaných časech se zaznamenanou dobou
+// zpracování, bez losování. Trace se čte po dávkách (RequestTraceReader).
+class ReplayRequestGenerator : public ArrivalGenerator {
+    RequestTraceReader& trace;
+    uint64_t next = 0;         // Index dalšího požadavku v trace
 
-/* GENERÁTOR POŽADAVKŮ */
-class RequestGenerator : public Event {
     void Behavior() {
-        (new Request)->Activate();
-        Activate(Time + GetInterarrivalTime());
+        ScheduleNext();
+    }
+public:
+    ReplayRequestGenerator(RequestTraceReader& trace) : trace(trace) {}
+
+    void ScheduleNext() override {
+        if (next >= trace.Records())
+            return;
+        const RequestRecord& r = trace.Replay(next++);
+        SpawnRequests(max(r.time, (double)Time), r.service_demand);
     }
 };
 
+thread_local ArrivalGenerator* arrival_generator = nullptr;   // Generátor běžící simulace
+
+void ScheduleNextArrival() {
+    if (arrival_generator != nullptr)
+        arrival_generator->ScheduleNext();
+}
+
+bool batch_arrivals = true;    // Hromadné generování příchodů (jinak RequestGenerator)
+
 
 /* FUNKCE PRO PŘIDÁNÍ A ODEBRÁNÍ KONTEJNERŮ */
-void AddContainer() {
+// Pozice vybírá bitová mapa aktivních kontejnerů: nejnižší neaktivní pozice
+// je buď kontejner k reaktivaci, nebo první dosud nevytvořený
+void Cluster::AddContainer() {
     if (total_containers < MAX_CONTAINERS) {
-        Container* container_to_activate = nullptr;
-        // Vyhledáme neaktivní kontejner k reaktivaci
-        for (int i = 0; i < max_containers_created; i++) {
-            if (!containers[i]->is_active) {
-                container_to_activate = containers[i];
-                break;
-            }
-        }
-
-        if (container_to_activate != nullptr) {
+        int id = active_slots.FirstClear();
+        if (id >= 0 && id < max_containers_created) {
             // Reaktivujeme existující kontejner
-            container_to_activate->Activate();
-            (new ContainerStartup(container_to_activate))->Activate(Time + CONTAINER_STARTUP_TIME);
-            cout << "Reaktivuji kontejner " << container_to_activate->id << ", bude připraven v čase " << PrintTime(Time + CONTAINER_STARTUP_TIME) << endl;
-        } else if (max_containers_created < MAX_CONTAINERS) {
+            containers[id]->Activate();
+            (new ContainerStartup(this, containers[id]))->Activate(Time + CONTAINER_STARTUP_TIME);
+            if (verbose)
+                Log() << "Reaktivuji kontejner " << id << ", bude připraven v čase " << PrintTime(Time + CONTAINER_STARTUP_TIME) << endl;
+        } else if (id >= 0) {
             // Vytvoříme nový kontejner
-            int id = max_containers_created;
-            containers[id] = new Container(id);
+            containers[id] = new Container(ready_index, state, active_slots, id);
             max_containers_created++;
             containers[id]->Activate();
-            (new ContainerStartup(containers[id]))->Activate(Time + CONTAINER_STARTUP_TIME);
-            cout << "Spouštím nový kontejner " << id << ", bude připraven v čase " << PrintTime(Time + CONTAINER_STARTUP_TIME) << endl;
+            (new ContainerStartup(this, containers[id]))->Activate(Time + CONTAINER_STARTUP_TIME);
+            if (verbose)
+                Log() << "Spouštím nový kontejner " << id << ", bude připraven v čase " << PrintTime(Time + CONTAINER_STARTUP_TIME) << endl;
         } else {
             // Nelze přidat další kontejnery
-            cout << "Nelze přidat další kontejnery, dosažen maximální počet." << endl;
+            if (verbose)
+                Log() << "Nelze přidat další kontejnery, dosažen maximální počet." << endl;
             return;
         }
         total_containers++;
     }
 }
-void RemoveContainer() {
+void Cluster::RemoveContainer() {
     if (total_containers > MIN_CONTAINERS) {
-        // Najdeme aktivní kontejner s nejvyšším ID k deaktivaci
-        for (int i = max_containers_created - 1; i >= 0; i--) {
-            if (containers[i]->is_active) {
-                containers[i]->Deactivate();
-                total_containers--;
-                cout << "Deaktivuji kontejner " << containers[i]->id << " v čase " << PrintTime(Time) << endl;
-                break;
-            }
+        // Deaktivujeme aktivní kontejner s nejvyšším ID
+        int id = active_slots.LastSet();
+        if (id >= 0) {
+            containers[id]->Deactivate();
+            total_containers--;
+            if (verbose)
+                Log() << "Deaktivuji kontejner " << id << " v čase " << PrintTime(Time) << endl;
         }
     }
 }
@@ -306,18 +717,47 @@ void RemoveContainer() {
 
 /* AUTOSCALERY */
 
+/* STAV PRO ROZHODNUTÍ */
+// Doplní průběžně udržovaný stav o čas, průměrnou zátěž a intenzitu příchodů
+const ClusterSnapshot& Cluster::Snapshot() {
+    state.time = Time;
+    state.total = total_containers;
+    state.average_load = (state.ready > 0) ? state.load / state.ready : 0.0;
+    state.arrival_rate = (Time > last_decision) ? arrivals / (Time - last_decision) : 0.0;
+    arrivals = 0;
+    last_decision = Time;
+    return state;
+}
+
+// Změna, která přiblíží total kontejnerů k required (s prahy SCALE_*_THRESHOLD)
+int ScaleTowards(int required, int total) {
+    // Zajištění minimálního a maximálního počtu kontejnerů
+    required = max(required, MIN_CONTAINERS);
+    required = min(required, MAX_CONTAINERS);
+
+    // Škálování o požadovaný počet kontejnerů
+    if (required >= total + SCALE_UP_THRESHOLD)
+        return min(required - total, MAX_CONTAINERS - total);
+    if (required <= total - SCALE_DOWN_THRESHOLD)
+        return -min(total - required, total - MIN_CONTAINERS);
+    return 0;
+}
+
 /* PREDIKTIVNÍ METODA */
-class PredictiveAutoscaler : public Event {
-    void Behavior() {
-        int next_interval = ((int)(Time / SIMULATION_INTERVAL) + 1) % (SIMULATION_TIME / SIMULATION_INTERVAL);
+class PredictivePolicy : public AutoscalerPolicy {
+public:
+    const char* Label() const override { return "Prediktivní"; }
+
+    int Decide(const ClusterSnapshot& cluster, string*) override {
+        long next_interval = (long)(cluster.time / SIMULATION_INTERVAL) + 1;
 
         /* Výpočet maximálního množství požadavků za minutu 
         v horizontu SCALING_INTERVAL (době zpřístupnění nového kontejneru) + CONTAINER_STARTUP_TIME (doba vytvoření nového kontejneru)*/
         int max_predicted_requests = 0;
         for (int i = floor(CONTAINER_STARTUP_TIME / SIMULATION_INTERVAL); i < (SCALING_INTERVAL + ceil(CONTAINER_STARTUP_TIME / SIMULATION_INTERVAL)); ++i) {
-            int idx = min(((next_interval + i) % (SIMULATION_TIME / SIMULATION_INTERVAL)), ((SIMULATION_TIME / SIMULATION_INTERVAL) - 1)) ;
-            if (max_predicted_requests < predicted_load[idx]){
-                max_predicted_requests = predicted_load[idx];
+            int predicted = load_window.Predicted(next_interval + i);
+            if (max_predicted_requests < predicted){
+                max_predicted_requests = predicted;
             }
         }
         max_predicted_requests = max_predicted_requests / SIMULATION_INTERVAL;
@@ -325,24 +765,82 @@ class PredictiveAutoscaler : public Event {
         double average_procesing_time = SERVICE_TIME * (1 + (ALPHA * DESIRED_LOAD));
         // Odhadnutý počet potřebných kontejnerů
         int required_containers = ((max_predicted_requests * average_procesing_time) / (DESIRED_LOAD)) + 1;
+        return ScaleTowards(required_containers, cluster.total);
+    }
+};
 
-        // Zajištění minimálního a maximálního počtu kontejnerů
-        required_containers = max(required_containers, MIN_CONTAINERS);
-        required_containers = min(required_containers, MAX_CONTAINERS);
+RegisterPolicy predictive_policy("PREDICTIVE", [] { return new PredictivePolicy; });
 
-        // Škálování o požadovaný počet kontejnerů
-        if (required_containers >= total_containers + SCALE_UP_THRESHOLD) {
-            int containers_to_add = min(required_containers - total_containers, MAX_CONTAINERS - total_containers);
-            for (int i = 0; i < containers_to_add; ++i) {
-                AddContainer();
+/* REAKTIVNÍ METODA */
+// Podle průměrné zátěže připravených kontejnerů
+// (nahoru jen tehdy, když se žádný kontejner právě nespouští)
+class ReactivePolicy : public AutoscalerPolicy {
+public:
+    const char* Label() const override { return "Reaktivní"; }
+
+    int Decide(const ClusterSnapshot& cluster, string* note) override {
+        // Škálování nahoru
+        if (cluster.average_load > SCALE_UP_LOAD && cluster.total < MAX_CONTAINERS) {
+            if (cluster.starting == 0)
+                return 1;
+            if (note != nullptr)
+                *note = "Čekám na spuštění kontejnerů, již se spouští " + to_string(cluster.starting) + " kontejnerů.";
+            return 0;
+        }
+        // Škálování dolů
+        if (cluster.average_load < SCALE_DOWN_LOAD && cluster.total > MIN_CONTAINERS)
+            return -1;
+        return 0;
+    }
+};
+
+RegisterPolicy reactive_policy("REACTIVE", [] { return new ReactivePolicy; });
+
+/* SLEDOVÁNÍ CÍLOVÉ ZÁTĚŽE */
+// Počet kontejnerů podle změřené intenzity příchodů od minulého rozhodnutí:
+// podle Littleova zákona je zátěž kontejneru λ * S / n, pro zátěž DESIRED_LOAD
+// (doba zpracování S = SERVICE_TIME * (1 + ALPHA * DESIRED_LOAD)) tedy
+// n = λ * S / DESIRED_LOAD. Bez predikce, na rozdíl od REACTIVE ale škáluje
+// o celý rozdíl najednou.
+class TargetTrackingPolicy : public AutoscalerPolicy {
+public:
+    const char* Label() const override { return "Cílové"; }
+
+    int Decide(const ClusterSnapshot& cluster, string*) override {
+        if (cluster.arrival_rate <= 0)
+            return 0;   // Zatím bez měření (první rozhodnutí)
+        double processing_time = SERVICE_TIME * (1 + ALPHA * DESIRED_LOAD);
+        return ScaleTowards((int)ceil(cluster.arrival_rate * processing_time / DESIRED_LOAD), cluster.total);
+    }
+};
+
+RegisterPolicy target_policy("TARGET", [] { return new TargetTrackingPolicy; });
+
+
+/* AUTOSCALER CLUSTERU */
+// Každých SCALING_INTERVAL minut provede rozhodnutí politiky clusteru
+class Autoscaler : public Event {
+    Cluster* cluster;
+public:
+    Autoscaler(Cluster* cluster) : cluster(cluster) {}
+
+    void Behavior() {
+        string note;
+        int change = cluster->policy->Decide(cluster->Snapshot(), verbose ? &note : nullptr);
+        if (change > 0) {
+            for (int i = 0; i < change; ++i) {
+                cluster->AddContainer();
             }
-            cout << "Prediktivní škálování nahoru na " << total_containers << " kontejnerů v čase " << PrintTime(Time) << endl;
-        } else if (required_containers <= total_containers - SCALE_DOWN_THRESHOLD) {
-            int containers_to_remove = min(total_containers - required_containers, total_containers - MIN_CONTAINERS);
-            for (int i = 0; i < containers_to_remove; ++i) {
-                RemoveContainer();
+            if (verbose)
+                cluster->Log() << cluster->policy->Label() << " škálování nahoru na " << cluster->total_containers << " kontejnerů v čase " << PrintTime(Time) << endl;
+        } else if (change < 0) {
+            for (int i = 0; i < -change; ++i) {
+                cluster->RemoveContainer();
             }
-            cout << "Prediktivní škálování dolů na " << total_containers << " kontejnerů v čase " << PrintTime(Time) << endl;
+            if (verbose)
+                cluster->Log() << cluster->policy->Label() << " škálování dolů na " << cluster->total_containers << " kontejnerů v čase " << PrintTime(Time) << endl;
+        } else if (!note.empty()) {
+            cluster->Log() << note << endl;
         }
         
         // Uspání po čas další kontroly
@@ -351,120 +849,159 @@ class PredictiveAutoscaler : public Event {
 };
 
 
-/* REAKTIVNÍ METODA */
-class ReactiveAutoscaler : public Event {
-public:
+/* UZAVŘENÍ INTERVALU ZÁTĚŽE */
+// Na každé hranici intervalu uzavře souhrny zátěže všech kontejnerů
+class LoadRollup : public Event {
     void Behavior() {
-        // Spočítáme průměrnou zátěž pouze z připravených kontejnerů
-        double total_load = 0.0;
-        int active_ready_containers = 0;
-        for (int i = 0; i < max_containers_created; i++) {
-            if (containers[i]->is_active && containers[i]->is_ready) {
-                total_load += containers[i]->load;
-                active_ready_containers++;
-            }
-        }
-        double average_load = 0.0;
-        if (active_ready_containers > 0) {
-            average_load = total_load / active_ready_containers;
-        }
+        for (Cluster* cluster : clusters)
+            for (int i = 0; i < cluster->max_containers_created; i++)
+                if (Time > cluster->containers[i]->OpenIntervalStart())   // Ne kontejner vytvořený právě teď
+                    cluster->containers[i]->RollupLoad(Time);
+        Activate(Time + SIMULATION_INTERVAL);
+    }
+};
 
-        // Počet kontejnerů ve spouštění
-        int starting_containers = 0;
-        for (int i = 0; i < max_containers_created; i++) {
-            if (containers[i]->is_active && !containers[i]->is_ready) {
-                starting_containers++;
-            }
+// Časová řada zátěže kontejnerů clusteru jako CSV (-L); poslední, neúplný
+// interval se uzavře v aktuálním čase. Průměr je přes část intervalu, kterou
+// souhrn pokrývá (od vytvoření kontejneru, do aktuálního času)
+void WriteLoadSeries(ostream& out, Cluster& cluster) {
+    for (int i = 0; i < cluster.max_containers_created; i++) {
+        Container* container = cluster.containers[i];
+        if (Time > container->OpenIntervalStart())
+            container->RollupLoad(Time);
+        long interval = container->first_interval;
+        for (const LoadSample& sample : container->load_series) {
+            double start = (double)interval * SIMULATION_INTERVAL;
+            double length = min(start + SIMULATION_INTERVAL, (double)Time) - max(start, container->creation_time);
+            out << cluster.scaling_model << "," << i << "," << interval * SIMULATION_INTERVAL << ","
+                << ((length > 0) ? sample.integral / length : 0.0) << "," << sample.max << "\n";
+            interval++;
         }
+    }
+}
 
-        // Škálování nahoru
-        if (average_load > SCALE_UP_LOAD && total_containers < MAX_CONTAINERS) {
-            int containers_to_add = 1; // Můžete upravit podle potřeby
-            // Zohledníme počet kontejnerů ve spouštění
-            int available_slots = MAX_CONTAINERS - total_containers;
-            containers_to_add = min(containers_to_add, available_slots);
-
-            if (starting_containers == 0) {
-                for (int i = 0; i < containers_to_add; ++i) {
-                    AddContainer();
-                }
-                cout << "Reaktivní škálování nahoru na " << total_containers << " kontejnerů v čase " << PrintTime(Time) << endl;
-            } else {
-                cout << "Čekám na spuštění kontejnerů, již se spouští " << starting_containers << " kontejnerů." << endl;
-            }
-        }
 
-        // Škálování dolů
-        else if (average_load < SCALE_DOWN_LOAD && total_containers > MIN_CONTAINERS) {
-            RemoveContainer();
-            cout << "Reaktivní škálování dolů na " << total_containers << " kontejnerů v čase " << PrintTime(Time) << endl;
+/* VZORKOVÁNÍ METRIK */
+// Každých metrics_interval sekund zapíše řádek metrik všech clusterů:
+// okamžité hodnoty (kontejnery, fronta, zátěž) a přírůstky čítačů za periodu
+class MetricsSampler : public Event {
+    MetricsRecorder& recorder;
+    struct Last {
+        long arrivals = 0, completed = 0, violations = 0;
+        double response_time_sum = 0.0;
+    };
+    vector<Last> last;
+
+    void Behavior() {
+        int column = 0;
+        recorder.Append(column++, Time);
+        for (size_t k = 0; k < clusters.size(); k++) {
+            Cluster* c = clusters[k];
+            double response_time_sum = c->response_time_stat.Sum();
+            long completed = c->total_requests - last[k].completed;
+            recorder.Append(column++, c->total_containers);
+            recorder.Append(column++, c->state.ready);
+            recorder.Append(column++, c->state.starting);
+            recorder.Append(column++, c->waiting_requests.Length());
+            recorder.Append(column++, c->state.load);
+            recorder.Append(column++, c->total_arrivals - last[k].arrivals);
+            recorder.Append(column++, completed);
+            recorder.Append(column++, c->sla_violations - last[k].violations);
+            recorder.Append(column++, (completed > 0) ? (response_time_sum - last[k].response_time_sum) / completed : 0.0);
+            last[k] = {c->total_arrivals, c->total_requests, c->sla_violations, response_time_sum};
+        }
+        if (!recorder.EndRow()) {
+            cerr << "Zápis metrik: " << strerror(errno) << endl;
+            exit(1);
+        }
+        Activate(Time + metrics_interval);
+    }
+public:
+    // Přidá sloupce pro clustery běžící simulace
+    MetricsSampler(MetricsRecorder& recorder) : recorder(recorder), last(clusters.size()) {
+        recorder.AddColumn("time", MetricsRecorder::DOUBLE);
+        for (Cluster* c : clusters) {
+            const string& m = c->scaling_model;
+            recorder.AddColumn(m + ".containers", MetricsRecorder::INT32);
+            recorder.AddColumn(m + ".ready", MetricsRecorder::INT32);
+            recorder.AddColumn(m + ".starting", MetricsRecorder::INT32);
+            recorder.AddColumn(m + ".waiting", MetricsRecorder::INT32);
+            recorder.AddColumn(m + ".load", MetricsRecorder::FLOAT);
+            recorder.AddColumn(m + ".arrivals", MetricsRecorder::INT32);
+            recorder.AddColumn(m + ".completed", MetricsRecorder::INT32);
+            recorder.AddColumn(m + ".sla_violations", MetricsRecorder::INT32);
+            recorder.AddColumn(m + ".mean_response_time", MetricsRecorder::FLOAT);
         }
-        
-        // Uspání po čas další kontroly
-        Activate(Time + SCALING_INTERVAL*60);
     }
 };
 
+// Soubor metrik běhu: při samostatných bězích více modelů (-P separate)
+// má každý model vlastní soubor s názvem modelu před příponou
+string RunMetricsPath(const string& path, const string& model, bool per_model) {
+    if (path.empty() || !per_model)
+        return path;
+    size_t dot = path.rfind('.');
+    size_t slash = path.rfind('/');
+    if (dot == string::npos || (slash != string::npos && dot < slash))
+        return path + "-" + model;
+    return path.substr(0, dot) + "-" + model + path.substr(dot);
+}
+
+bool metrics_per_model = false;                // Soubor metrik pro každý model zvlášť
+
 
 /* INITIALIZACE KONTEJNERŮ */
-void InitContainers(int count) {
+void Cluster::InitContainers(int count) {
     for (int i = 0; i < count; i++) {
-        containers[i] = new Container(i);
-        containers[i]->is_active = true;
-        containers[i]->is_ready = true;
+        containers[i] = new Container(ready_index, state, active_slots, i);
+        containers[i]->Start();
         total_containers++;
         max_containers_created++;
     }
 }
 
 
-/* HLAVNÍ FUNKCE */
-int main() {
-
-    // Inicializace simulace
-    Init(0, SIMULATION_TIME);
-    RandomSeed(time(NULL));
-
-    // Inicializace pole containers na nullptr
-    for (int i = 0; i < MAX_CONTAINERS; i++) {
-        containers[i] = nullptr;
-    }
-
-    // Generování predikované zátěže
-    GeneratePredictedLoad();
-    
-    // Generování reálné zátěže
-    GenerateRealRequestsPerMinute();
-
-    // Inicializace kontejnerů
-    InitContainers(MIN_CONTAINERS);
-
-    // Spuštění generátoru požadavků
-    (new RequestGenerator)->Activate();
+/* VÝSLEDKY JEDNOHO BĚHU */
+struct ReplicationResult {
+    double sla_percentage;       // Procento požadavků obsloužených v rámci SLA
+    double mean_response_time;   // Průměrná doba odezvy (response_time_stat)
+    double operating_cost;       // Celkové náklady na provoz
+    int max_containers;          // Maximální počet vytvořených kontejnerů
+    string response_times;       // Obraz response_time_stat (Stat::Serialize), u fluidního modelu prázdný
+};
 
-    // Spuštění autoscaleru
-    if (SCALING_MODEL == "REACTIVE")
-        (new ReactiveAutoscaler)->Activate();
-    else if (SCALING_MODEL == "PREDICTIVE")
-        (new PredictiveAutoscaler)->Activate();
-    else{
-        cerr << "Prosím vyberte škálovací model: (\"REACTIVE\" nebo \"PREDICTIVE\")";
-        return 1;
-    }
 
-    // Spuštění simulace
-    Run();
+/* VÝSLEDKY CLUSTERU */
+// Při verbose vypisuje histogram, SLA, zátěž kontejnerů a náklady
+ReplicationResult Cluster::Results() {
+    ReplicationResult result;
 
     // Výstup výsledků
     //response_time_stat.Output();
-    response_time_hist.Output();
+    if (verbose) {
+        if (!prefix.empty())
+            cout << "=== " << scaling_model << " ===" << endl;
+        response_time_hist.Output();
+    }
 
-    double sla_percentage = 100.0 * (1 - ((double)sla_violations / total_requests));
-    cout << "SLA splněno pro " << sla_percentage << "% požadavků." << endl;
+    result.sla_percentage = 100.0 * (1 - ((double)sla_violations / total_requests));
+    result.mean_response_time = response_time_stat.MeanValue();
+    result.max_containers = max_containers_created;
+    result.response_times = response_time_stat.Serialize();
+    if (verbose)
+        cout << "SLA splněno pro " << result.sla_percentage << "% požadavků." << endl;
+    if (verbose && response_time_quantiles.Number() > 0) {
+        cout << "Doba odezvy (±" << 100 * response_time_quantiles.RelativeError() << " %):";
+        for (double p : {0.5, 0.95, 0.99, 0.999})
+            cout << " p" << 100 * p << " = " << response_time_quantiles.Quantile(p);
+        cout << endl;
+    }
 
     // Výstup statistik zátěže kontejnerů
     for (int i = 0; i < max_containers_created; i++) {
-        cout << "Kontejner " << i << " průměrná zátěž: " << containers[i]->load_stat->MeanValue() << endl;
+        if (verbose)
+            cout << "Kontejner " << i << " průměrná zátěž: " << containers[i]->MeanLoad()
+                 << ", max. " << containers[i]->MaxLoad() << endl;
     }
 
     // Výpočet a výstup celkových nákladů
@@ -478,14 +1015,668 @@ int main() {
         double container_cost = active_hours * COST_PER_CONTAINER;
         total_operating_cost += container_cost;
     }
-    cout << "Celkové náklady na provoz: " << total_operating_cost << endl;
+    result.operating_cost = total_operating_cost;
+    if (verbose)
+        cout << "Celkové náklady na provoz: " << total_operating_cost << endl;
+    return result;
+}
 
-    // Uvolnění paměti
+// Uvolnění paměti
+Cluster::~Cluster() {
     for (int i = 0; i < max_containers_created; i++) {
-        delete containers[i]->load_stat;
         delete containers[i];
         containers[i] = nullptr;
     }
+    waiting_requests.Clear();   // Požadavky, na které do konce nezbyl kontejner
+}
+
+
+/* JEDEN BĚH SIMULACE */
+// Simuluje model ve stavu aktuálního vlákna: jeden cluster pro každý
+// škálovací model, všechny na stejných příchodech. Při verbose vypisuje
+// průběh a výsledky. Vrací výsledky v pořadí models.
+vector<ReplicationResult> RunSimulation(const vector<string>& scaling_models, long seed, unsigned long replication) {
+
+    // Inicializace simulace
+    SetCalendar(calendar_name.c_str());
+    Init(0, simulation_time);
+    SeedStreams(seed, replication);
+
+    // Zdroj zátěže: predikovaná a reálná zátěž se generuje průběžně (LoadWindow)
+    WorkloadSource workload;
+
+    // Clustery s inicializovanými kontejnery a jejich autoscalery
+    // (název modelu kontroluje main)
+    vector<unique_ptr<Cluster>> owned;
+    for (const string& model : scaling_models) {
+        owned.emplace_back(new Cluster(model));
+        Cluster* cluster = owned.back().get();
+        if (scaling_models.size() > 1)
+            cluster->prefix = "[" + model + "] ";
+        clusters.push_back(cluster);
+        cluster->InitContainers(MIN_CONTAINERS);
+    }
+
+    // Spuštění generátoru požadavků
+    // (řetězené generátory jsou lokální: nemusí být v kalendáři, když Run() skončí)
+    BatchRequestGenerator batch_generator;
+    ReplayRequestGenerator replay_generator(workload.replay);
+    if (replay_trace != nullptr)
+        arrival_generator = &replay_generator;
+    else if (batch_arrivals)
+        arrival_generator = &batch_generator;
+    if (arrival_generator != nullptr)
+        arrival_generator->Activate();
+    else
+        (new RequestGenerator)->Activate();
+
+    // Spuštění autoscalerů
+    for (Cluster* cluster : clusters)
+        (new Autoscaler(cluster))->Activate();
+    (new LoadRollup)->Activate(SIMULATION_INTERVAL);
+
+    // Vzorkování metrik (jen při jednom běhu)
+    MetricsRecorder metrics;
+    if (verbose && (!metrics_path.empty() || !metrics_csv_path.empty())) {
+        const string& model = scaling_models[0];
+        string path = RunMetricsPath(metrics_path, model, metrics_per_model);
+        string csv_path = RunMetricsPath(metrics_csv_path, model, metrics_per_model);
+        MetricsSampler* sampler = new MetricsSampler(metrics);
+        if (!metrics.Open(path, csv_path)) {
+            cerr << (path.empty() ? csv_path : path) << ": " << strerror(errno) << endl;
+            exit(1);
+        }
+        sampler->Activate(metrics_interval);
+    }
+
+    // Spuštění simulace
+    Run();
+    arrival_generator = nullptr;
+    if (!metrics.Close()) {
+        cerr << "Zápis metrik: " << strerror(errno) << endl;
+        exit(1);
+    }
+
+    vector<ReplicationResult> results;
+    for (Cluster* cluster : clusters) {
+        results.push_back(cluster->Results());
+        if (load_series_out != nullptr)
+            WriteLoadSeries(*load_series_out, *cluster);
+    }
+    clusters.clear();
+    return results;
+}
+
+
+/* RYCHLÝ FLUIDNÍ MODEL */
+// Místo jednotlivých požadavků sleduje střední počet N požadavků v clusteru.
+// Výběr nejméně vytíženého kontejneru vyrovnává zátěž na L = N / R
+// (R připravených kontejnerů), požadavek se zpracovává po dobu
+// S(L) = SERVICE_TIME * (1 + ALPHA * (1 + L)) (sám se do zátěže započítá),
+// takže
+//     dN/dt = λ - N / S(N / R)
+// V ustáleném stavu je to Littleův zákon N = λ * S(L), při přetížení N roste
+// rychlostí λ - R / (SERVICE_TIME * ALPHA). V každém podkroku FLUID_SUBSTEP
+// se S považuje za konstantní a rovnice se řeší přesně (exponenciální
+// přiblížení k λ * S), takže podkrok může být delší než doba zpracování.
+// Intenzita příchodů a autoscalery se vyhodnocují po FLUID_STEP. Požadavky jsou v systému
+// nezávisle (M/G/nekonečno), počet v systému je tedy přibližně Poissonův.
+// Autoscalery používají stejné politiky jako simulace (AutoscalerPolicy)
+// a stejné okno zátěže.
+const double FLUID_STEP = 1.0;                     // Krok příchodů a autoscalerů (v sekundách)
+const double FLUID_SUBSTEP = 0.25;                 // Krok integrace (v sekundách)
+
+// Pravděpodobnost P(X >= k) pro X s Poissonovým rozdělením se střední hodnotou
+// mean (normální aproximace s korekcí na spojitost)
+double PoissonTail(double mean, double k) {
+    if (mean <= 0)
+        return (k <= 0) ? 1.0 : 0.0;
+    double z = (k - 0.5 - mean) / sqrt(2.0 * mean);
+    if (z > 6.0)
+        return 0.0;         // Pod 1e-17, erfc nepočítáme
+    return 0.5 * erfc(z);
+}
+
+ReplicationResult RunFluid(const string& scaling_model, long seed, unsigned long replication) {
+    SeedStreams(seed, replication);
+    WorkloadSource workload;
+
+    // Zátěž, od které požadavek nesplní SLA: SERVICE_TIME * (1 + ALPHA * zátěž) > SLA
+    const double sla_load = (SLA_RESPONSE_TIME / SERVICE_TIME - 1) / ALPHA;
+    unique_ptr<AutoscalerPolicy> policy = CreatePolicy(scaling_model);
+
+    // Pozice kontejnerů jako v Cluster: přidává se na nejnižší volnou,
+    // ruší se aktivní s nejvyšším ID (AddContainer, RemoveContainer)
+    vector<double> ready_at(MAX_CONTAINERS, -1.0);   // Čas připravenosti, záporný = neaktivní
+    fill(ready_at.begin(), ready_at.begin() + MIN_CONTAINERS, 0.0);
+    int ready = MIN_CONTAINERS;            // Připravené kontejnery
+    int starting = 0;                      // Spouštěné kontejnery
+    double first_ready = INFINITY;         // Nejbližší připravenost spouštěného kontejneru
+    auto count = [&](double t) {
+        ready = starting = 0;
+        first_ready = INFINITY;
+        for (double r : ready_at) {
+            if (r < 0)
+                continue;
+            if (r <= t)
+                ready++;
+            else {
+                starting++;
+                first_ready = min(first_ready, r);
+            }
+        }
+    };
+    int max_total = ready;
+    double requests = 0.0;
+    double violations = 0.0;
+    double response_time_sum = 0.0;
+    double container_seconds = 0.0;
+    double next_check = 0.0;
+    double in_system = 0.0;                // Střední počet požadavků v clusteru (N)
+    double arrivals_since_check = 0.0;     // Příchody od minulé kontroly autoscaleru
+    double last_check = 0.0;
+
+    for (double t = 0.0; t < simulation_time; t += FLUID_STEP) {
+        // Dokončené spouštění kontejnerů
+        if (first_ready <= t)
+            count(t);
+        int total = ready + starting;
+
+        // Kontrola autoscaleru
+        if (t >= next_check) {
+            ClusterSnapshot snapshot;
+            snapshot.time = t;
+            snapshot.ready = ready;
+            snapshot.starting = starting;
+            snapshot.total = total;
+            snapshot.load = in_system;
+            snapshot.average_load = (ready > 0) ? in_system / ready : 0.0;
+            snapshot.arrival_rate = (t > last_check) ? arrivals_since_check / (t - last_check) : 0.0;
+            arrivals_since_check = 0.0;
+            last_check = t;
+
+            int change = policy->Decide(snapshot, nullptr);
+            for (; change > 0 && total < MAX_CONTAINERS; change--, total++)
+                *find_if(ready_at.begin(), ready_at.end(), [](double r) { return r < 0; }) = t + CONTAINER_STARTUP_TIME;
+            for (; change < 0 && total > MIN_CONTAINERS; change++, total--)
+                *find_if(ready_at.rbegin(), ready_at.rend(), [](double r) { return r >= 0; }) = -1.0;
+            count(t);
+            max_total = max(max_total, total);
+            next_check += SCALING_INTERVAL * 60;
+        }
+
+        double rate = load_window.Real((long)(t / SIMULATION_INTERVAL)) / (double)SIMULATION_INTERVAL;
+        double arrivals = rate * FLUID_STEP;
+        requests += arrivals;
+        arrivals_since_check += arrivals;
+        container_seconds += total * FLUID_STEP;
+
+        if (ready == 0) {
+            // Požadavky čekají na první spouštěný kontejner, rozpracované doběhnou
+            double wait = (starting == 0) ? FLUID_STEP : first_ready - t;
+            violations += arrivals;
+            response_time_sum += arrivals * (wait + SERVICE_TIME * (1 + ALPHA));
+            in_system *= exp(-FLUID_STEP / (SERVICE_TIME * (1 + ALPHA)));
+            continue;
+        }
+
+        // Integrace počtu požadavků; odezva a porušení SLA podle zátěže,
+        // kterou příchozí požadavky v každém podkroku vidí
+        const int substeps = (int)ceil(FLUID_STEP / FLUID_SUBSTEP);
+        const double h = FLUID_STEP / substeps;
+        for (int k = 0; k < substeps; k++) {
+            double load = in_system / ready;
+            double response_time = SERVICE_TIME * (1 + ALPHA * (1 + load));
+            response_time_sum += rate * h * response_time;
+            violations += rate * h * PoissonTail(in_system, ready * floor(sla_load));
+            double steady = rate * response_time;
+            in_system = steady + (in_system - steady) * exp(-h / response_time);
+        }
+    }
+
+    ReplicationResult result;
+    result.sla_percentage = 100.0 * (1 - violations / requests);
+    result.mean_response_time = response_time_sum / requests;
+    result.operating_cost = container_seconds / 3600.0 * COST_PER_CONTAINER;
+    result.max_containers = max_total;
+    if (verbose) {
+        cout << "Fluidní model " << scaling_model << ", " << PrintTime(simulation_time) << endl;
+        cout << "Průměrná doba odezvy: " << result.mean_response_time << endl;
+        cout << "SLA splněno pro " << result.sla_percentage << "% požadavků." << endl;
+        cout << "Maximální počet kontejnerů: " << result.max_containers << endl;
+        cout << "Celkové náklady na provoz: " << result.operating_cost << endl;
+    }
+    return result;
+}
+
+// Jeden běh zvoleným modelem pro všechny škálovací modely se stejným seedem
+// (fluidní model je na seedu závislý jen přes zátěž, běhy jsou tedy párové)
+vector<ReplicationResult> Simulate(const vector<string>& scaling_models, long seed, unsigned long replication = 0) {
+    if (!fluid_engine)
+        return RunSimulation(scaling_models, seed, replication);
+    vector<ReplicationResult> results;
+    for (const string& model : scaling_models)
+        results.push_back(RunFluid(model, seed, replication));
+    return results;
+}
+
+
+/* REPLIKACE */
+
+// Kvantil t(0.975, df) Studentova rozdělení pro 95% interval spolehlivosti
+double StudentT95(unsigned long df) {
+    static const double table[] = {
+        0, 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (df <= 30)
+        return table[df];
+    // Mezi tabelovanými hodnotami bereme kvantil pro nižší df (širší interval)
+    return (df < 40) ? 2.042 : (df < 60) ? 2.021 : (df < 120) ? 2.000 : 1.980;
+}
+
+// Polovina šířky 95% intervalu spolehlivosti průměru
+double HalfWidth(const Stat& s) {
+    if (s.Number() < 2)
+        return HUGE_VAL;
+    return StudentT95(s.Number() - 1) * s.StdDev() / sqrt((double)s.Number());
+}
+
+// Souhrn replikací jednoho škálovacího modelu
+struct ReplicationSummary {
+    Stat sla_percentage;
+    Stat mean_response_time;
+    Stat operating_cost;
+    Stat max_containers;
+    Stat response_times;        // Doby odezvy všech požadavků sloučené z replikací
+
+    void Add(const ReplicationResult& r) {
+        sla_percentage(r.sla_percentage);
+        mean_response_time(r.mean_response_time);
+        operating_cost(r.operating_cost);
+        max_containers(r.max_containers);
+        if (!r.response_times.empty()) {
+            Stat replication;
+            replication.Deserialize(r.response_times);
+            response_times.Merge(replication);
+        }
+    }
+
+    // Párový rozdíl a - b dvou modelů ze stejné replikace
+    void AddDifference(const ReplicationResult& a, const ReplicationResult& b) {
+        sla_percentage(a.sla_percentage - b.sla_percentage);
+        mean_response_time(a.mean_response_time - b.mean_response_time);
+        operating_cost(a.operating_cost - b.operating_cost);
+        max_containers(a.max_containers - b.max_containers);
+    }
+
+    // Polovina šířky intervalu všech ukazatelů je nejvýše target * |průměr|
+    bool Precise(double target) const {
+        for (const Stat* s : {&sla_percentage, &mean_response_time, &operating_cost, &max_containers}) {
+            if (HalfWidth(*s) > target * fabs(s->MeanValue()))
+                return false;
+        }
+        return true;
+    }
+
+    // Totéž pro párové rozdíly vůči modelu base: cíl je target * větší
+    // z |průměr rozdílu| a |průměr base|, u rozdílu blízkého nule je tedy
+    // absolutní (podíl úrovně ukazatele základního modelu)
+    bool PreciseDifference(double target, const ReplicationSummary& base) const {
+        const Stat* d[] = {&sla_percentage, &mean_response_time, &operating_cost, &max_containers};
+        const Stat* b[] = {&base.sla_percentage, &base.mean_response_time, &base.operating_cost, &base.max_containers};
+        for (int i = 0; i < 4; i++) {
+            if (HalfWidth(*d[i]) > target * max(fabs(d[i]->MeanValue()), fabs(b[i]->MeanValue())))
+                return false;
+        }
+        return true;
+    }
+};
+
+/* SOUBĚŽNÉ REPLIKACE */
+// Replikace i používá RandomSeed(seed, i) (nezávislé proudy) a běží ve
+// vlastním SimulationContext v jednom z pracovních vláken. Výsledky se do
+// souhrnu přidávají v pořadí replikací a přesnost se testuje po každé
+// z nich, takže počet použitých replikací (a souhrn) nezávisí na počtu
+// vláken. Replikace rozběhnuté po dosažení přesnosti se zahodí. Všechny
+// modely replikace běží ve stejném průchodu (Simulate); differences (pokud
+// není nullptr) dostane párové rozdíly modelů 1.. vůči modelu 0 a přesnost
+// se pak testuje na nich (PreciseDifference), ne na modelech samotných.
+// Vrací počet použitých replikací.
+int RunReplications(const vector<string>& scaling_models, long seed, int max_replications, int min_replications,
+                    double target, int threads, vector<ReplicationSummary>& summary,
+                    vector<ReplicationSummary>* differences = nullptr) {
+    vector<vector<ReplicationResult>> results(max_replications);
+    vector<bool> finished(max_replications, false);
+    int next = 0;           // Další replikace k přidělení vláknu
+    int used = 0;           // Replikace 0..used-1 jsou v souhrnu
+    bool stop = false;      // Dosažena požadovaná přesnost
+    mutex lock;
+
+    auto worker = [&]() {
+        for (;;) {
+            int i;
+            {
+                lock_guard<mutex> guard(lock);
+                if (stop || next >= max_replications)
+                    return;
+                i = next++;
+            }
+            vector<ReplicationResult> result;
+            {
+                SimulationContext context;  // Vlastní kalendář, čas a generátor náhodných čísel
+                context.Select();
+                result = Simulate(scaling_models, seed, i);
+            }
+            lock_guard<mutex> guard(lock);
+            results[i] = result;
+            finished[i] = true;
+            while (!stop && used < max_replications && finished[used]) {
+                const vector<ReplicationResult>& r = results[used++];
+                bool paired = differences != nullptr && r.size() > 1;
+                bool precise = true;
+                for (size_t k = 0; k < r.size(); k++) {
+                    summary[k].Add(r[k]);
+                    if (paired && k > 0) {
+                        (*differences)[k - 1].AddDifference(r[k], r[0]);
+                        precise = precise && (*differences)[k - 1].PreciseDifference(target, summary[0]);
+                    } else if (!paired)
+                        precise = precise && summary[k].Precise(target);
+                }
+                if (target > 0 && used >= min_replications && precise)
+                    stop = true;
+            }
+        }
+    };
+
+    vector<thread> workers;
+    for (int i = 0; i < min(threads, max_replications); i++)
+        workers.emplace_back(worker);
+    for (thread& t : workers)
+        t.join();
+    return used;
+}
+
+// Výpis průměru s 95% intervalem spolehlivosti
+void PrintInterval(const char* name, const Stat& s) {
+    cout << "  " << name << ": " << s.MeanValue();
+    if (s.Number() >= 2)
+        cout << " ± " << HalfWidth(s);
+    cout << endl;
+}
+
+
+/* KALIBRACE FLUIDNÍHO MODELU */
+// Stejné seedy simulací po požadavcích a fluidním modelem; pro každý ukazatel
+// průměr simulace s 95% intervalem spolehlivosti, průměr fluidního modelu
+// a jeho relativní chyba, nakonec doba jednoho běhu
+void Calibrate(const vector<string>& models, long seed, int replications, int threads) {
+    cout << "Kalibrace fluidního modelu: " << replications << " replikací, seed " << seed
+         << ", " << PrintTime(simulation_time) << endl;
+    for (const string& model : models) {
+        vector<ReplicationSummary> summary[2] = {vector<ReplicationSummary>(1), vector<ReplicationSummary>(1)};
+        const ReplicationSummary& des = summary[0][0];
+        const ReplicationSummary& fluid = summary[1][0];
+        double seconds[2];
+        for (int f = 0; f < 2; f++) {
+            fluid_engine = (f == 1);
+            auto start = chrono::steady_clock::now();
+            RunReplications({model}, seed, replications, replications, 0.0, threads, summary[f]);
+            seconds[f] = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        }
+        fluid_engine = false;
+
+        // (setw počítá bajty, "í" v UTF-8 má dva)
+        cout << left << setw(28) << model << right << setw(20) << "simulace"
+             << setw(19) << "fluidní" << setw(14) << "chyba" << endl;
+        const char* names[] = {"SLA splněno [%]", "Průměrná doba odezvy [s]", "Náklady na provoz", "Max. počet kontejnerů"};
+        const Stat* d[] = {&des.sla_percentage, &des.mean_response_time, &des.operating_cost, &des.max_containers};
+        const Stat* f[] = {&fluid.sla_percentage, &fluid.mean_response_time, &fluid.operating_cost, &fluid.max_containers};
+        for (int i = 0; i < 4; i++) {
+            ostringstream interval;
+            interval << setprecision(5) << d[i]->MeanValue() << " ± " << setprecision(2) << HalfWidth(*d[i]);
+            double error = 100.0 * (f[i]->MeanValue() - d[i]->MeanValue()) / d[i]->MeanValue();
+            cout << "  " << left << setw(26) << names[i] << right << setw(20) << interval.str()
+                 << setw(18) << setprecision(5) << f[i]->MeanValue()
+                 << setw(12) << showpos << fixed << setprecision(2) << error << " %" << noshowpos << defaultfloat << endl;
+        }
+        cout << "  Doba jednoho běhu [ms]" << setw(25) << fixed << setprecision(1) << 1000 * seconds[0] / replications
+             << setw(18) << setprecision(3) << 1000 * seconds[1] / replications << defaultfloat << endl;
+    }
+}
+
+
+/* PARAMETRY PŘÍKAZOVÉ ŘÁDKY */
+void Usage(const char* program) {
+    cerr << "Použití: " << program << " [-m model[,model...]|BOTH] [-s seed]"
+            " [-r max_replikací] [-n min_replikací] [-e přesnost] [-j vlákna]"
+            " [-a batch|event] [-t trace] [-R trace_požadavků] [-H hodiny]"
+            " [-E des|fluid|calibrate] [-P separate|shadow] [-k kalendář]"
+            " [-L zátěž.csv] [-M metriky] [-C metriky.csv] [-I sekundy]\n"
+            "  -m M        škálovací model: REACTIVE, PREDICTIVE, TARGET (cílová\n"
+            "              zátěž podle intenzity příchodů), BOTH = REACTIVE,PREDICTIVE\n"
+            "  bez -r      jeden běh s výpisem průběhu (seed z času, pokud chybí -s)\n"
+            "  -r K        až K replikací každého modelu, replikace 0..K-1 seedu seed\n"
+            "  -n N        minimální počet replikací před testem přesnosti (5)\n"
+            "  -e E        konec, když polovina šířky 95% intervalu spolehlivosti\n"
+            "              všech ukazatelů klesne pod E * průměr (např. 0.01); při\n"
+            "              -P shadow párových rozdílů vůči prvnímu modelu, pod E * větší\n"
+            "              z průměru rozdílu a průměru prvního modelu\n"
+            "  -j J        počet souběžných vláken (počet jader)\n"
+            "  -a A        generování příchodů: batch = po intervalech (výchozí),\n"
+            "              event = jedna událost na požadavek (původní)\n"
+            "  -t T        zátěž z binárního trace (viz trace_convert) místo dataset.hpp\n"
+            "  -R R        přehrání zaznamenaných požadavků (trace_convert -r),\n"
+            "              bez losování; predikce je přesný počet příchodů\n"
+            "  -H H        délka simulace v hodinách (24, s -t/-R délka trace);\n"
+            "              po konci dat se zátěž opakuje od začátku (mimo -R)\n"
+            "  -E E        des = simulace po požadavcích (výchozí), fluid = rychlý\n"
+            "              fluidní model, calibrate = porovnání obou (-r replikací, 10)\n"
+            "  -P P        separate = každý model samostatně (výchozí), shadow = všechny\n"
+            "              modely v jednom průchodu na stejných příchodech, s párovými\n"
+            "              rozdíly vůči prvnímu modelu\n"
+            "  -L L        při jednom běhu zapíše do CSV souboru L zátěž kontejnerů po\n"
+            "              intervalech: model,kontejner,začátek,průměr,maximum\n"
+            "  -M M        při jednom běhu zapíše metriky clusterů po periodách -I do\n"
+            "              sloupcového binárního souboru M (formát viz metrics.hpp):\n"
+            "              kontejnery, fronta, zátěž, příchody, dokončené požadavky,\n"
+            "              porušení SLA a průměrná odezva za periodu\n"
+            "  -C C        tytéž metriky jako CSV (s -M i bez něj)\n"
+            "  -I I        perioda vzorkování metrik v sekundách (60)\n"
+            "  -k K        kalendář SIMLIB: list (výchozí), cq, heap, ladder\n"
+            "              (při -P shadow výchozí heap)\n";
+}
+
+
+// Název kalendáře pro SetCalendar
+bool IsCalendarName(const string& name) {
+    for (unsigned i = 0; CalendarName(i) != nullptr; i++)
+        if (name == CalendarName(i))
+            return true;
+    return name == "default";
+}
+
+
+/* HLAVNÍ FUNKCE */
+int main(int argc, char* argv[]) {
+    string scaling_model = "";
+    long seed = time(NULL);
+    int max_replications = 0;   // 0 = jeden běh s výpisem průběhu
+    int min_replications = 5;
+    double target = 0.0;
+    int threads = max(1u, thread::hardware_concurrency());
+    double hours = 0.0;         // 0 = podle zdroje zátěže
+    bool calibrate = false;
+    bool shadow = false;        // Všechny modely v jednom průchodu
+    string load_series_path;    // CSV se zátěží kontejnerů (-L)
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (i + 1 >= argc) {
+            Usage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        if (arg == "-m")
+            scaling_model = value;
+        else if (arg == "-s")
+            seed = atol(value);
+        else if (arg == "-r")
+            max_replications = atoi(value);
+        else if (arg == "-n")
+            min_replications = max(2, atoi(value));
+        else if (arg == "-e")
+            target = atof(value);
+        else if (arg == "-j")
+            threads = max(1, atoi(value));
+        else if (arg == "-a" && (string(value) == "batch" || string(value) == "event"))
+            batch_arrivals = (string(value) == "batch");
+        else if (arg == "-t")
+            trace_path = value;
+        else if (arg == "-R")
+            replay_path = value;
+        else if (arg == "-E" && (string(value) == "des" || string(value) == "fluid" || string(value) == "calibrate")) {
+            fluid_engine = (string(value) == "fluid");
+            calibrate = (string(value) == "calibrate");
+        }
+        else if (arg == "-k" && IsCalendarName(value))
+            calendar_name = value;
+        else if (arg == "-P" && (string(value) == "separate" || string(value) == "shadow"))
+            shadow = (string(value) == "shadow");
+        else if (arg == "-L")
+            load_series_path = value;
+        else if (arg == "-M")
+            metrics_path = value;
+        else if (arg == "-C")
+            metrics_csv_path = value;
+        else if (arg == "-I" && atof(value) > 0)
+            metrics_interval = atof(value);
+        else if (arg == "-H" && atof(value) > 0)
+            hours = atof(value);
+        else {
+            Usage(argv[0]);
+            return 1;
+        }
+    }
+
+    // Kontrola trace (každý běh si ho pak namapuje sám)
+    if (!trace_path.empty()) {
+        TraceReader trace;
+        if (!trace.Open(trace_path)) {
+            cerr << trace.Error() << endl;
+            return 1;
+        }
+        if (SIMULATION_INTERVAL % trace.Interval() != 0) {
+            cerr << trace_path << ": interval trace " << trace.Interval()
+                 << " s nedělí interval simulace " << SIMULATION_INTERVAL << " s" << endl;
+            return 1;
+        }
+        simulation_time = trace.Duration();
+    }
+    if (!replay_path.empty()) {
+        RequestTraceReader replay;
+        if (!replay.Open(replay_path)) {
+            cerr << replay.Error() << endl;
+            return 1;
+        }
+        // Do konce intervalu s posledním příchodem
+        simulation_time = (floor(replay.Duration() / SIMULATION_INTERVAL) + 1) * SIMULATION_INTERVAL;
+    }
+    if (hours > 0)
+        simulation_time = hours * 3600;
+
+    vector<string> models;
+    if (scaling_model.empty())
+        scaling_model = (max_replications > 0 || calibrate) ? "BOTH" : SCALING_MODEL;
+    if (scaling_model == "BOTH")
+        models = {"REACTIVE", "PREDICTIVE"};
+    else {
+        // Jeden model nebo seznam oddělený čárkami (např. REACTIVE,TARGET)
+        stringstream list(scaling_model);
+        string model;
+        while (getline(list, model, ','))
+            models.push_back(model);
+    }
+    for (const string& model : models) {
+        if (PolicyRegistry().count(model) == 0) {
+            cerr << "Prosím vyberte škálovací model:";
+            for (const auto& policy : PolicyRegistry())
+                cerr << " " << policy.first;
+            cerr << " nebo BOTH (REACTIVE,PREDICTIVE)" << endl;
+            return 1;
+        }
+    }
+
+    // Více clusterů v jednom kalendáři: seřazený seznam by s počtem
+    // naplánovaných událostí zpomaloval
+    if (shadow && calendar_name == "default")
+        calendar_name = "heap";
+
+    if (calibrate) {
+        verbose = false;
+        Calibrate(models, seed, (max_replications > 0) ? max_replications : 10, threads);
+        return 0;
+    }
+
+    // Jeden běh: průběh a výsledky jednoho modelu (při -P shadow všech najednou)
+    if (max_replications <= 0) {
+        ofstream load_series_file;
+        if (!load_series_path.empty()) {
+            load_series_file.open(load_series_path);
+            if (!load_series_file) {
+                cerr << load_series_path << ": " << strerror(errno) << endl;
+                return 1;
+            }
+            load_series_file << "model,container,interval_start,mean_load,max_load\n";
+            load_series_out = &load_series_file;
+        }
+        metrics_per_model = !shadow && models.size() > 1;
+        if (shadow)
+            Simulate(models, seed);
+        else
+            for (const string& model : models)
+                Simulate({model}, seed);
+        load_series_out = nullptr;
+        return 0;
+    }
+
+    // Replikace: stejné seedy pro oba modely (společná náhodná čísla)
+    verbose = false;
+    cout << "Replikace: seed " << seed << ", max. " << max_replications << ", vláken " << threads;
+    if (target > 0)
+        cout << ", přesnost " << target;
+    cout << endl;
+    auto print = [&](const string& name, int used, const ReplicationSummary& summary, const char* precision = "přesnost") {
+        cout << name << ": " << used << " replikací";
+        if (used < max_replications)
+            cout << " (dosažena " << precision << ")";
+        cout << endl;
+        PrintInterval("SLA splněno [%]", summary.sla_percentage);
+        PrintInterval("Průměrná doba odezvy [s]", summary.mean_response_time);
+        PrintInterval("Náklady na provoz", summary.operating_cost);
+        PrintInterval("Max. počet kontejnerů", summary.max_containers);
+        if (summary.response_times.Number() > 1)
+            cout << "  Doba odezvy všech " << summary.response_times.Number() << " požadavků [s]: "
+                 << summary.response_times.MeanValue() << ", sm. odchylka " << summary.response_times.StdDev() << endl;
+    };
+    if (shadow) {
+        // Jeden průchod pro všechny modely, párové rozdíly vůči prvnímu
+        vector<ReplicationSummary> summary(models.size()), differences(models.size() - 1);
+        int used = RunReplications(models, seed, max_replications, min_replications, target, threads,
+                                   summary, &differences);
+        const char* precision = (models.size() > 1) ? "přesnost párových rozdílů" : "přesnost";
+        for (size_t k = 0; k < models.size(); k++)
+            print(models[k], used, summary[k], precision);
+        for (size_t k = 1; k < models.size(); k++)
+            print("Párový rozdíl " + models[k] + " - " + models[0], used, differences[k - 1], precision);
+        return 0;
+    }
+    for (const string& model : models) {
+        vector<ReplicationSummary> summary(1);
+        int used = RunReplications({model}, seed, max_replications, min_replications, target, threads, summary);
+        print(model, used, summary[0]);
+    }
 
     return 0;
 }
@@ -0,0 +1,171 @@
+/*
+ *  Název: Sloupcový záznam časových řad metrik
+ *
+ *  MetricsRecorder sbírá vzorky (řádky) pevné sady sloupců do sloupcových
+ *  bufferů v paměti. Po METRICS_ROW_GROUP řádcích je zapíše jako jednu
+ *  skupinu řádků do binárního souboru, volitelně i do CSV, přes FILE
+ *  s velkým bufferem. Paměť tedy nezávisí na délce běhu a zápis je
+ *  sekvenční.
+ *
+ *  Formát souboru (little-endian):
+ *    hlavička  "SIMMETRC", uint32 verze, uint32 počet sloupců, pro každý
+ *              sloupec: uint8 typ ('d' double, 'f' float, 'i' int32),
+ *              uint8 délka názvu, název
+ *    skupiny   uint32 počet řádků n, za ním pro každý sloupec (v pořadí
+ *              hlavičky) n hodnot jeho typu
+ *    konec     skupina s n = 0
+ */
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#define METRICS_MAGIC "SIMMETRC"
+const uint32_t METRICS_VERSION = 1;
+const uint32_t METRICS_ROW_GROUP = 4096;          // Řádků v jedné skupině
+const size_t METRICS_FILE_BUFFER = 1 << 20;       // Buffer FILE (1 MiB)
+
+class MetricsRecorder {
+public:
+    enum Type : uint8_t { DOUBLE = 'd', FLOAT = 'f', INT32 = 'i' };
+
+    ~MetricsRecorder() { Close(); }
+
+    // Přidá sloupec (před Open), vrací jeho index
+    int AddColumn(const std::string& name, Type type) {
+        columns.push_back({name.substr(0, 255), type, {}});
+        return (int)columns.size() - 1;
+    }
+
+    // Otevře binární soubor a CSV (pokud csv_path není prázdný) a zapíše hlavičky
+    bool Open(const std::string& path, const std::string& csv_path = "") {
+        if (!path.empty() && !OpenFile(file, path))
+            return false;
+        if (!csv_path.empty() && !OpenFile(csv, csv_path))
+            return false;
+        for (Column& c : columns)
+            c.values.reserve(METRICS_ROW_GROUP);
+        rows = 0;
+        return WriteHeader();
+    }
+
+    // Hodnota sloupce v aktuálním řádku; do každého sloupce jedna na řádek
+    void Append(int column, double value) {
+        columns[column].values.push_back(value);
+    }
+
+    // Ukončí řádek, plná skupina se zapíše
+    bool EndRow() {
+        rows++;
+        return (columns.empty() || columns[0].values.size() < METRICS_ROW_GROUP) || Flush();
+    }
+
+    uint64_t Rows() const { return rows; }
+
+    // Zapíše zbývající řádky a ukončovací skupinu
+    bool Close() {
+        bool ok = Flush();
+        if (file != nullptr) {
+            uint32_t end = 0;
+            ok = fwrite(&end, sizeof(end), 1, file) == 1 && ok;
+            ok = (fclose(file) == 0) && ok;
+            file = nullptr;
+        }
+        if (csv != nullptr) {
+            ok = (fclose(csv) == 0) && ok;
+            csv = nullptr;
+        }
+        return ok;
+    }
+
+private:
+    struct Column {
+        std::string name;
+        Type type;
+        std::vector<double> values;   // Řádky aktuální skupiny
+    };
+    std::vector<Column> columns;
+    std::vector<char> chunk;          // Převedené hodnoty jednoho sloupce
+    FILE* file = nullptr;
+    FILE* csv = nullptr;
+    uint64_t rows = 0;
+
+    static bool OpenFile(FILE*& f, const std::string& path) {
+        f = fopen(path.c_str(), "wb");
+        return f != nullptr && setvbuf(f, nullptr, _IOFBF, METRICS_FILE_BUFFER) == 0;
+    }
+
+    bool WriteHeader() {
+        bool ok = true;
+        if (file != nullptr) {
+            uint32_t version = METRICS_VERSION, count = (uint32_t)columns.size();
+            ok = fwrite(METRICS_MAGIC, 8, 1, file) == 1 && fwrite(&version, sizeof(version), 1, file) == 1 &&
+                 fwrite(&count, sizeof(count), 1, file) == 1;
+            for (const Column& c : columns) {
+                uint8_t header[2] = {c.type, (uint8_t)c.name.size()};
+                ok = ok && fwrite(header, 2, 1, file) == 1 && fwrite(c.name.data(), 1, c.name.size(), file) == c.name.size();
+            }
+        }
+        if (csv != nullptr) {
+            for (size_t k = 0; k < columns.size(); k++)
+                fprintf(csv, "%s%s", k ? "," : "", columns[k].name.c_str());
+            ok = fputc('\n', csv) != EOF && ok;
+        }
+        return ok;
+    }
+
+    template <typename T>
+    void Convert(const std::vector<double>& values) {
+        chunk.resize(values.size() * sizeof(T));
+        T* out = reinterpret_cast<T*>(chunk.data());
+        for (size_t i = 0; i < values.size(); i++)
+            out[i] = (T)values[i];
+    }
+
+    // Zapíše skupinu řádků z bufferů a buffery vyprázdní
+    bool Flush() {
+        uint32_t n = columns.empty() ? 0 : (uint32_t)columns[0].values.size();
+        if (n == 0)
+            return true;
+        bool ok = true;
+        if (file != nullptr) {
+            ok = fwrite(&n, sizeof(n), 1, file) == 1;
+            for (const Column& c : columns) {
+                if (c.type == DOUBLE)
+                    Convert<double>(c.values);
+                else if (c.type == FLOAT)
+                    Convert<float>(c.values);
+                else
+                    Convert<int32_t>(c.values);
+                ok = ok && fwrite(chunk.data(), 1, chunk.size(), file) == chunk.size();
+            }
+        }
+        if (csv != nullptr) {
+            for (uint32_t i = 0; i < n; i++) {
+                for (size_t k = 0; k < columns.size(); k++) {
+                    const Column& c = columns[k];
+                    // Čísla s přesností, která se přečte zpět na stejnou hodnotu
+                    // jako v binárním souboru (double 17, float 9 číslic)
+                    if (c.type == INT32)
+                        fprintf(csv, k ? ",%d" : "%d", (int32_t)c.values[i]);
+                    else if (c.type == DOUBLE)
+                        fprintf(csv, k ? ",%.17g" : "%.17g", c.values[i]);
+                    else
+                        fprintf(csv, k ? ",%.9g" : "%.9g", (double)(float)c.values[i]);
+                }
+                fputc('\n', csv);
+            }
+            ok = !ferror(csv) && ok;
+        }
+        for (Column& c : columns)
+            c.values.clear();
+        return ok;
+    }
+};
+
+#endif
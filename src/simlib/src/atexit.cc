@@ -13,6 +13,7 @@
 
 #include "simlib.h"
 #include "internal.h"
+#include <mutex>
 
 namespace simlib3 {
 
@@ -21,12 +22,15 @@ SIMLIB_IMPLEMENTATION;
 static const int MAX_ATEXIT = 10; // for internal use it is enough
 static int counter = 0; // internal module counter
 static SIMLIB_atexit_function_t atexit_array[MAX_ATEXIT] = { 0, };
+static std::mutex atexit_mutex; // registration from simulation threads
 
 // used in SIMLIB
 void SIMLIB_atexit(SIMLIB_atexit_function_t p) {
     DEBUG(DBG_ATEXIT,("SIMLIB_atexit(%p)", p ));
+    std::lock_guard<std::mutex> lock(atexit_mutex);
     int i;
     for(i=0; i<MAX_ATEXIT; i++) {
+       if(atexit_array[i]==p) return; // already registered (SetCalendar)
        if(atexit_array[i]==0) break;
     }
     if(i<MAX_ATEXIT)
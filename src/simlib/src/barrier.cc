@@ -67,7 +67,7 @@ void Barrier::Enter(Entity * e) //TODO without parameter: use Current?
         e->Passivate();
     } else {                    // last process which breaks barrier
         Break();
-        Current->Activate();    // re-activation of last process - FIFO order
+        SIMLIB_Current->Activate();    // re-activation of last process - FIFO order
     }
 }
 
@@ -77,14 +77,14 @@ void Barrier::Enter(Entity * e) //TODO without parameter: use Current?
 //
 bool Barrier::Wait()
 {
-    Dprintf(("Barrier\"%s\".Wait() for %s", Name().c_str(), Current->Name().c_str()));
+    Dprintf(("Barrier\"%s\".Wait() for %s", Name().c_str(), SIMLIB_Current->Name().c_str()));
     if (n < maxn - 1) {         // all waiting processes
-        waiting[n++] = Current;
-        Current->Passivate();
+        waiting[n++] = SIMLIB_Current;
+        SIMLIB_Current->Passivate();
         return false;
     } else {                    // last process which breaks barrier
         Break();
-        Current->Activate(Time);    // re-activation of last process - FIFO order
+        SIMLIB_Current->Activate(SIMLIB_Time);    // re-activation of last process - FIFO order
         return true;
     }
 }
@@ -10,6 +10,7 @@
 /// <br> interface is static - using global functions in SQS namespace
 ///
 /// <br> uses double-linked list and dynamic calendar queue [brown1988]
+/// <br> alternatives: 4-ary heap and ladder queue [tang2005]
 //
 // FIXME: Warning: experimental code, needs improvements
 // TODO: improve interface
@@ -22,7 +23,11 @@
 #include "simlib.h"
 #include "internal.h"
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <cstring>
+#include <new>
+#include <vector>
 
 //#define MEASURE // comment this to switch off
 #ifdef MEASURE
@@ -94,21 +99,20 @@ class Calendar { // abstract base class
   private:
     double mintime;     //!< activation time of first event
   ///////////////////////////////////////////////////////////////////////////
-  // singleton:
+  // singleton (single instance per SimulationContext, in SIMLIB_state):
   public:
     static Calendar * instance();       //!< create/get single instance (singleton)
     /// check if the instance exists
     static bool instance_exists() {
-        return _instance != 0;
+        return SIMLIB_state.calendar != 0;
     }
   protected:
     Calendar(): _size(0), mintime(SIMLIB_MAXTIME) {}
     virtual ~Calendar() {} //!< clear is called in derived class dtr
     static void delete_instance();      //!< destroy single instance
-  private:
-    static Calendar * _instance;        //!< pointer to single instance
   ///////////////////////////////////////////////////////////////////////////
-  friend void SetCalendar(const char *name); // sets _instance
+  friend void SetCalendar(const char *name); // sets instance
+  friend void SIMLIB_CalendarDelete();
 };
 
 /////////////////////////////////////////////////////////////////////////////
@@ -149,12 +153,15 @@ struct EventNotice : public EventNoticeLinkBase {
     double time;
     /// priority at the time of scheduling
     Entity::Priority_t priority;
+    /// index in array-based calendars (CalendarHeap), unused by lists
+    unsigned pos;
 
     EventNotice(Entity *p, double t) :
         //inherited: pred(this), succ(this), // == NOT linked
         entity(p),              // which entity
         time(t),                // activation time
-        priority(p->Priority)   // current scheduling priority
+        priority(p->Priority),  // current scheduling priority
+        pos(0)
     {
         create_reverse_link();
     }
@@ -175,15 +182,6 @@ struct EventNotice : public EventNoticeLinkBase {
         }
     }
 
-    /// set new values to existing (unlinked) record
-    void Set(Entity *e, double t) {
-        pred=succ=this;
-        entity = e;             // which entity
-        time = t;               // activation time
-        priority = e->Priority; // current scheduling priority
-        create_reverse_link();
-    }
-
     static EventNotice *Create(Entity *p, double t);
     static void Destroy(EventNotice *en);
 
@@ -193,56 +191,190 @@ struct EventNotice : public EventNoticeLinkBase {
 };
 
 
-// TODO: update interface to be compatible with std:: allocators
+/// chunk of activation records for EventNoticeAllocator
+/// <br> aligned to its size, so the chunk of any record is found by masking
+/// the address; free slots are marked in bitmap
+struct EventNoticeChunk {
+    static const size_t SIZE = 64 * 1024;       //!< bytes (power of 2)
+    static const unsigned WORDS = SIZE / sizeof(EventNotice) / 64 + 1;
+    unsigned index;             //!< position in allocator directory
+    unsigned used;              //!< number of allocated records
+    unsigned hint;              //!< lowest bitmap word with free slot
+    uint64_t free_map[WORDS];   //!< bit==1: free slot
+    static const unsigned SLOTS;
+    /// start of record storage (after this header)
+    EventNotice *slots() {
+        const size_t h = (sizeof(EventNoticeChunk) + alignof(EventNotice) - 1)
+                         & ~(alignof(EventNotice) - 1);
+        return reinterpret_cast<EventNotice*>(reinterpret_cast<char*>(this) + h);
+    }
+    static EventNoticeChunk *of(EventNotice *en) {
+        return reinterpret_cast<EventNoticeChunk*>(
+                   reinterpret_cast<uintptr_t>(en) & ~uintptr_t(SIZE - 1));
+    }
+    void init(unsigned i) {
+        index = i;
+        used = 0;
+        hint = 0;
+        for (unsigned w = 0; w < WORDS; w++) {
+            unsigned bits = SLOTS > 64 * w ? SLOTS - 64 * w : 0;
+            free_map[w] = bits >= 64 ? ~uint64_t(0)
+                                     : (uint64_t(1) << bits) - 1;
+        }
+    }
+    /// get free slot with the lowest address
+    EventNotice *take() {
+        while (free_map[hint] == 0)
+            hint++;
+        unsigned bit = __builtin_ctzll(free_map[hint]);
+        free_map[hint] &= free_map[hint] - 1;
+        used++;
+        return slots() + 64 * hint + bit;
+    }
+    void give(EventNotice *en) {
+        unsigned n = en - slots();
+        free_map[n / 64] |= uint64_t(1) << (n % 64);
+        if (n / 64 < hint)
+            hint = n / 64;
+        used--;
+    }
+    bool full() const { return used == SLOTS; }
+};
+const unsigned EventNoticeChunk::SLOTS =
+    (EventNoticeChunk::SIZE - sizeof(EventNoticeChunk) - alignof(EventNotice))
+    / sizeof(EventNotice);
+static_assert((EventNoticeChunk::SIZE - sizeof(EventNoticeChunk)) / sizeof(EventNotice)
+              <= 64 * EventNoticeChunk::WORDS, "EventNoticeChunk bitmap too small");
+
 /// allocate activation records fast
-// TODO: use std::list
+/// <br> slab allocator: records are carved from large aligned chunks,
+/// the free slot with the lowest address is used first (chunks are ordered
+/// by address), so calendar items stay dense; empty chunks are returned
+/// to the system when they exceed 1/8 of all chunks (plus SPARE)
+/// <br> all members are POD: the allocator can be used during cleanup at
+/// program exit (calendar is destroyed by the last SIMLIB module)
 class EventNoticeAllocator {
-    static const unsigned MAXSIZELIMIT = 1000000;
-    EventNoticeLinkBase *l; // single-linked list of freed items
-    unsigned freed;
+    static const unsigned SPARE = 1;    //!< min. number of empty chunks kept
+    EventNoticeChunk **dir;     //!< chunks ordered by address
+    uint64_t *partial;          //!< bit i==1: dir[i] has free slot
+    unsigned nchunks;           //!< number of chunks
+    unsigned capacity;          //!< size of dir (multiple of 64)
+    unsigned hint;              //!< lowest partial word with nonzero bit
+    unsigned empty;             //!< number of chunks without records
+
+    void set_partial(unsigned i) {
+        partial[i / 64] |= uint64_t(1) << (i % 64);
+        if (i / 64 < hint)
+            hint = i / 64;
+    }
+    void clear_partial(unsigned i) {
+        partial[i / 64] &= ~(uint64_t(1) << (i % 64));
+    }
+    /// renumber chunks from position i and rebuild partial bitmap
+    void reindex(unsigned i) {
+        for (; i < nchunks; i++)
+            dir[i]->index = i;
+        for (unsigned w = 0; w < capacity / 64; w++)
+            partial[w] = 0;
+        hint = 0;
+        for (unsigned j = 0; j < nchunks; j++)
+            if (!dir[j]->full())
+                partial[j / 64] |= uint64_t(1) << (j % 64);
+    }
+    /// allocate new chunk and insert it into directory
+    EventNoticeChunk *new_chunk() {
+        if (nchunks == capacity) {
+            unsigned c = capacity ? 2 * capacity : 64;
+            EventNoticeChunk **d = static_cast<EventNoticeChunk**>(
+                                   std::realloc(dir, c * sizeof(*dir)));
+            uint64_t *p = static_cast<uint64_t*>(
+                          std::realloc(partial, c / 64 * sizeof(*partial)));
+            if (!d || !p)
+                SIMLIB_error("EventNoticeAllocator: no memory");
+            dir = d;
+            partial = p;
+            capacity = c;
+        }
+        void *mem = 0;
+        if (posix_memalign(&mem, EventNoticeChunk::SIZE, EventNoticeChunk::SIZE) != 0)
+            SIMLIB_error("EventNoticeAllocator: no memory");
+        EventNoticeChunk *c = static_cast<EventNoticeChunk*>(mem);
+        unsigned i = nchunks;
+        while (i > 0 && dir[i - 1] > c) {      // keep address order
+            dir[i] = dir[i - 1];
+            i--;
+        }
+        dir[i] = c;
+        nchunks++;
+        c->init(i);
+        empty++;
+        reindex(i);
+        SIMLIB_statistics.EventNoticeChunks = nchunks;
+        return c;
+    }
+    /// return empty chunk to the system
+    void release(EventNoticeChunk *c) {
+        unsigned i = c->index;
+        for (unsigned j = i + 1; j < nchunks; j++)
+            dir[j - 1] = dir[j];
+        nchunks--;
+        empty--;
+        std::free(c);
+        reindex(i);
+        SIMLIB_statistics.EventNoticeChunks = nchunks;
+        SIMLIB_statistics.EventNoticeChunksFreed++;
+    }
   public:
-    EventNoticeAllocator(): l(0), freed(0) {}
+    EventNoticeAllocator():
+        dir(0), partial(0), nchunks(0), capacity(0), hint(0), empty(0) {}
     ~EventNoticeAllocator() {
-        clear();  // delete freelist
+        clear();  // free empty chunks
     }
 
-    /// free EventNotice, add to freelist for future allocation
+    /// free EventNotice, return its slot to chunk
     void free(EventNotice *en) {
-        if(en->pred!=en) { // if scheduled
-            en->remove();  // unlink from calendar list
-            en->delete_reverse_link();
-        }
-        if(freed>MAXSIZELIMIT)  // limit the size of freelist
-            delete en;
-        else {
-            // add to freelist
-            en->succ=l;
-            l=en;
-            freed++;
-        }
+        en->~EventNotice();     // unlink from calendar list and entity
+        EventNoticeChunk *c = EventNoticeChunk::of(en);
+        if (c->full())
+            set_partial(c->index);
+        c->give(en);
+        SIMLIB_statistics.EventNoticeLive--;
+        if (c->used == 0 && ++empty > SPARE + nchunks / 8)
+            release(c);         // keep some spare chunks (hysteresis)
     }
-    /// EventNotice allocation or reuse from freelist
+    /// EventNotice allocation from the lowest-address free slot
     EventNotice *alloc(Entity *p, double t) {
-        if(l==0)
-            return new EventNotice(p, t);
-        else {
-            // get from freelist
-            freed--;
-            EventNotice *ptr = static_cast<EventNotice *>(l);
-            l = l->succ;
-            ptr->Set(p,t);
-            return ptr;
-        }
+        unsigned w = hint;
+        while (w < capacity / 64 && partial[w] == 0)
+            w++;
+        hint = w;
+        EventNoticeChunk *c;
+        if (w < capacity / 64)
+            c = dir[64 * w + __builtin_ctzll(partial[w])];
+        else
+            c = new_chunk();
+        if (c->used == 0)
+            empty--;
+        EventNotice *en = c->take();
+        if (c->full())
+            clear_partial(c->index);
+        SIMLIB_statistics_t &st = SIMLIB_statistics;
+        st.EventNoticeAllocs++;
+        if (++st.EventNoticeLive > st.EventNoticeMaxLive)
+            st.EventNoticeMaxLive = st.EventNoticeLive;
+        return new(en) EventNotice(p, t);
     }
-    /// clear: delete all free-list items
+    /// clear: return all empty chunks to the system
+    /// <br> called by each list destructor (e.g. buckets of CalendarQueue)
     void clear() {
-        while(l!=0) {
-            EventNotice *p = static_cast<EventNotice*>(l);
-            l=l->succ;
-            delete p;
-        }
+        for (unsigned i = nchunks; i > 0 && empty > 0; i--)
+            if (dir[i - 1]->used == 0)
+                release(dir[i - 1]);
     }
-} allocator;  // global allocator TODO: improve -> singleton
+};
+
+/// allocator of the thread (memory pool shared by contexts of the thread)
+static thread_local EventNoticeAllocator allocator;
 
 
 
@@ -442,7 +574,7 @@ inline void EventNotice::Destroy(EventNotice *en)
 void CalendarList::ScheduleAt(Entity *e, double t)
 {
 //  Dprintf(("CalendarList::ScheduleAt(%s,%g)", e->Name().c_str(), t));
-  if(t<Time)
+  if(t<SIMLIB_Time)
       SIMLIB_error(SchedulingBeforeTime);
   l.insert(e,t);
   ++_size;
@@ -646,7 +778,7 @@ CalendarQueue::CalendarQueue():
 void CalendarQueue::ScheduleAt(Entity *e, double t)
 {
     Dprintf(("CalendarQueue::ScheduleAt(%s,%g)", e->Name().c_str(), t));
-    if(t<Time)
+    if(t<SIMLIB_Time)
         SIMLIB_error(SchedulingBeforeTime);
 
     // if overgrown
@@ -1126,6 +1258,484 @@ CalendarQueue::~CalendarQueue()
 }
 
 
+////////////////////////////////////////////////////////////////////////////
+/// CalendarHeap --- implicit 4-ary heap of activation records
+//
+// heap items hold copies of the ordering keys, so sift operations do not
+// touch EventNotices except for the back index update
+// items sorted by: 1) time
+//                  2) priority
+//                  3) FIFO (sequence number of scheduling)
+//
+class CalendarHeap : public Calendar {
+    struct Item {
+        double time;                    //!< activation time
+        int prio;                       //!< priority at scheduling
+        unsigned long long seq;         //!< insertion order (FIFO)
+        EventNotice *evn;               //!< activation record
+    };
+    static const unsigned ARITY = 4;
+    std::vector<Item> heap;
+    unsigned long long seq;             //!< sequence number generator
+
+    /// ordering predicate: a should be dequeued before b
+    static bool before(const Item &a, const Item &b) {
+        if(a.time != b.time) return a.time < b.time;
+        if(a.prio != b.prio) return a.prio > b.prio;   // higher priority first
+        return a.seq < b.seq;
+    }
+    void place(unsigned i, const Item &it) {
+        heap[i] = it;
+        it.evn->pos = i;
+    }
+    void sift_up(unsigned i);
+    void sift_down(unsigned i);
+    Entity *remove_at(unsigned i);
+    void update_mintime() {
+        SetMinTime(heap.empty() ? SIMLIB_MAXTIME : heap[0].time);
+    }
+
+  public:
+    /// enqueue
+    virtual void ScheduleAt(Entity *p, double t) override;
+    /// dequeue
+    virtual Entity *Get(Entity *p) override;
+    /// dequeue first
+    virtual Entity *GetFirst() override;
+    /// remove all
+    virtual void clear(bool destroy=false) override;
+
+    /// create calendar instance
+    static CalendarHeap * create() {
+        Dprintf(("CalendarHeap::create()"));
+        CalendarHeap *cal = new CalendarHeap;
+        SIMLIB_atexit(delete_instance);     // last SIMLIB module cleanup calls it
+        return cal;
+    }
+    virtual const char* Name() override { return "CalendarHeap"; }
+
+ private:
+    CalendarHeap(): seq(0) {
+        Dprintf(("CalendarHeap::CalendarHeap()"));
+        SetMinTime( SIMLIB_MAXTIME ); // empty
+    }
+    ~CalendarHeap() {
+        Dprintf(("CalendarHeap::~CalendarHeap()"));
+        clear(true);
+        allocator.clear(); // clear freelist
+    }
+
+public:
+#ifndef NDEBUG
+    virtual void debug_print() override; // print of calendar contents - FOR DEBUGGING ONLY
+#endif
+};
+
+/// move item i up to its position
+void CalendarHeap::sift_up(unsigned i)
+{
+    Item it = heap[i];
+    while(i > 0) {
+        unsigned parent = (i - 1) / ARITY;
+        if(!before(it, heap[parent]))
+            break;
+        place(i, heap[parent]);
+        i = parent;
+    }
+    place(i, it);
+}
+
+/// move item i down to its position
+void CalendarHeap::sift_down(unsigned i)
+{
+    const unsigned n = heap.size();
+    Item it = heap[i];
+    for(;;) {
+        unsigned first = ARITY * i + 1;
+        if(first >= n)
+            break;
+        unsigned last = first + ARITY < n ? first + ARITY : n;
+        unsigned best = first;
+        for(unsigned c = first + 1; c < last; ++c)
+            if(before(heap[c], heap[best]))
+                best = c;
+        if(!before(heap[best], it))
+            break;
+        place(i, heap[best]);
+        i = best;
+    }
+    place(i, it);
+}
+
+/// remove item at position i, free its activation record
+Entity *CalendarHeap::remove_at(unsigned i)
+{
+    EventNotice *evn = heap[i].evn;
+    Entity *e = evn->entity;
+    Item last = heap.back();
+    heap.pop_back();
+    if(i < heap.size()) {
+        place(i, last);
+        if(i > 0 && before(last, heap[(i - 1) / ARITY]))
+            sift_up(i);
+        else
+            sift_down(i);
+    }
+    evn->delete_reverse_link();     // not linked in any list
+    EventNotice::Destroy(evn);
+    --_size;
+    return e;
+}
+
+/// schedule entity e at time t
+void CalendarHeap::ScheduleAt(Entity *e, double t)
+{
+    if(t<SIMLIB_Time)
+        SIMLIB_error(SchedulingBeforeTime);
+    EventNotice *evn = EventNotice::Create(e,t);
+    Item it = { t, evn->priority, seq++, evn };
+    heap.push_back(it);
+    sift_up(heap.size() - 1);
+    ++_size;
+    update_mintime();
+}
+
+/// dequeue first entity
+Entity *CalendarHeap::GetFirst()
+{
+    if(Empty())
+        SIMLIB_error(EmptyCalendar);
+    Entity *e = remove_at(0);
+    update_mintime();
+    return e;
+}
+
+/// remove entity e from calendar
+Entity *CalendarHeap::Get(Entity *e)
+{
+    if(Empty())
+        SIMLIB_error(EmptyCalendar);
+    if(e->Idle())
+        SIMLIB_error(EntityIsNotScheduled);
+    remove_at(e->GetEventNotice()->pos);
+    update_mintime();
+    return e;
+}
+
+/// remove all event notices, and optionally destroy entities
+void CalendarHeap::clear(bool destroy)
+{
+    Dprintf(("CalendarHeap::clear(destroy=%s)", destroy?"true":"false"));
+    while(!heap.empty()) {
+        Entity *e = remove_at(heap.size() - 1);   // no sifting
+        if(destroy && e->isAllocated()) delete e;
+    }
+    _size = 0;
+    seq = 0;
+    SetMinTime(SIMLIB_MAXTIME);
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// CalendarLadder tunable parameters:
+
+// max. bucket length before spawning a new rung
+const unsigned LADDER_THRES   = 50;
+// max. number of rungs
+const unsigned LADDER_MAXRUNGS = 8;
+
+////////////////////////////////////////////////////////////////////////////
+/// CalendarLadder --- ladder queue [tang2005]
+//
+//  Top     unsorted list of far future events
+//  Rungs   arrays of unsorted buckets, each rung refines one bucket
+//          of the rung above
+//  Bottom  short sorted list (CalendarListImplementation) of the
+//          nearest events, its first item is the calendar minimum
+//
+// FIFO order for equal time and priority is kept because events of
+// equal time always go to the same place and are moved in list order.
+//
+class CalendarLadder : public Calendar {
+    typedef EventNoticeLinkBase Bucket;     // unsorted circular list head
+    struct Rung {
+        Bucket  *buckets;       //!< bucket array
+        unsigned nbuckets;      //!< number of buckets
+        unsigned cur;           //!< first bucket not moved down
+        double   start;         //!< time of bucket[0] start
+        double   width;         //!< bucket width
+        /// bucket index (not limited) for time t
+        double index(double t) const { return (t - start) / width; }
+    };
+    Bucket top;                 //!< unsorted list of future events
+    unsigned ntop;              //!< number of items in top
+    double top_start;           //!< all items in top are >= top_start
+    Rung rungs[LADDER_MAXRUNGS];
+    unsigned nrungs;            //!< number of used rungs
+    CalendarListImplementation bottom;
+    unsigned nbottom;           //!< upper estimate of bottom length
+    unsigned bottom_limit;      //!< bottom length checked for spawning
+
+    static bool bucket_empty(const Bucket &b) { return b.succ == &b; }
+    static void append(Bucket &b, EventNotice *evn) { evn->insert(&b); }
+    static unsigned scan(Bucket &b, double &tmin, double &tmax);
+    void new_rung(Bucket &src, unsigned n, double tmin, double tmax);
+    void bucket_to_bottom(Bucket &b);
+    void top_to_rung();
+    void fill_bottom();
+    void spawn_bottom();
+    void update_mintime() {
+        SetMinTime(bottom.empty() ? SIMLIB_MAXTIME : bottom.first_time());
+    }
+
+  public:
+    /// enqueue
+    virtual void ScheduleAt(Entity *p, double t) override;
+    /// dequeue
+    virtual Entity *Get(Entity *p) override;
+    /// dequeue first
+    virtual Entity *GetFirst() override;
+    /// remove all
+    virtual void clear(bool destroy=false) override;
+
+    /// create calendar instance
+    static CalendarLadder * create() {
+        Dprintf(("CalendarLadder::create()"));
+        CalendarLadder *cal = new CalendarLadder;
+        SIMLIB_atexit(delete_instance);     // last SIMLIB module cleanup calls it
+        return cal;
+    }
+    virtual const char* Name() override { return "CalendarLadder"; }
+
+ private:
+    CalendarLadder():
+        ntop(0), top_start(SIMLIB_MINTIME),
+        nrungs(0), nbottom(0), bottom_limit(LADDER_THRES)
+    {
+        Dprintf(("CalendarLadder::CalendarLadder()"));
+        SetMinTime( SIMLIB_MAXTIME ); // empty
+    }
+    ~CalendarLadder() {
+        Dprintf(("CalendarLadder::~CalendarLadder()"));
+        clear(true);
+        allocator.clear(); // clear freelist
+    }
+
+public:
+#ifndef NDEBUG
+    virtual void debug_print() override; // print of calendar contents - FOR DEBUGGING ONLY
+#endif
+};
+
+/// count items of bucket and get their time range
+unsigned CalendarLadder::scan(Bucket &b, double &tmin, double &tmax)
+{
+    unsigned n = 0;
+    tmin = SIMLIB_MAXTIME;
+    tmax = -SIMLIB_MAXTIME;
+    for(Bucket *p = b.succ; p != &b; p = p->succ) {
+        double t = static_cast<EventNotice *>(p)->time;
+        if(t < tmin) tmin = t;
+        if(t > tmax) tmax = t;
+        ++n;
+    }
+    return n;
+}
+
+/// move sorted copy of bucket contents to bottom list
+void CalendarLadder::bucket_to_bottom(Bucket &b)
+{
+    while(!bucket_empty(b)) {
+        EventNotice *evn = static_cast<EventNotice *>(b.succ);
+        evn->remove();
+        bottom.insert_extracted(evn);
+        ++nbottom;
+    }
+}
+
+/// create new (lowest) rung and distribute n items of src into it
+void CalendarLadder::new_rung(Bucket &src, unsigned n, double tmin, double tmax)
+{
+    Rung &r = rungs[nrungs++];
+    r.nbuckets = n + 1;
+    r.cur = 0;
+    r.start = tmin;
+    r.width = (tmax - tmin) / n;
+    r.buckets = new Bucket[r.nbuckets];
+    while(!bucket_empty(src)) {
+        EventNotice *evn = static_cast<EventNotice *>(src.succ);
+        evn->remove();
+        double i = r.index(evn->time);
+        unsigned b = i < r.nbuckets ? static_cast<unsigned>(i) : r.nbuckets - 1;
+        append(r.buckets[b], evn);
+    }
+}
+
+/// distribute top list into the first rung
+void CalendarLadder::top_to_rung()
+{
+    double tmin, tmax;
+    unsigned n = scan(top, tmin, tmax);
+    ntop = 0;
+    if(tmax - tmin <= 1e-12 * tmax) {       // all items at (almost) the same time
+        bucket_to_bottom(top);
+        top_start = std::nextafter(tmax, SIMLIB_MAXTIME);
+        return;
+    }
+    new_rung(top, n, tmin, tmax);
+    Rung &r = rungs[0];
+    top_start = r.start + r.nbuckets * r.width;
+    if(!(top_start > tmax))
+        top_start = std::nextafter(tmax, SIMLIB_MAXTIME);
+}
+
+/// refill empty bottom from rungs or top
+void CalendarLadder::fill_bottom()
+{
+    while(bottom.empty() && _size > 0) {
+        nbottom = 0;
+        if(nrungs == 0) {
+            top_to_rung();
+            continue;
+        }
+        Rung &r = rungs[nrungs - 1];
+        while(r.cur < r.nbuckets && bucket_empty(r.buckets[r.cur]))
+            ++r.cur;
+        if(r.cur == r.nbuckets) {   // rung exhausted
+            delete [] r.buckets;
+            --nrungs;
+            continue;
+        }
+        Bucket &b = r.buckets[r.cur++];
+        double tmin, tmax;
+        unsigned n = scan(b, tmin, tmax);
+        if(n > LADDER_THRES && nrungs < LADDER_MAXRUNGS && tmax - tmin > 1e-12 * tmax)
+            new_rung(b, n, tmin, tmax);   // refine the bucket
+        else
+            bucket_to_bottom(b);
+    }
+    if(_size == 0) {            // restart ladder from current time
+        while(nrungs > 0)
+            delete [] rungs[--nrungs].buckets;
+        ntop = 0;
+        top_start = SIMLIB_Time;
+        nbottom = 0;
+    }
+}
+
+/// too long bottom list: move it into new rung
+void CalendarLadder::spawn_bottom()
+{
+    double tmin, tmax;
+    Bucket tmp;
+    unsigned n = 0;
+    while(!bottom.empty()) {            // extract sorted items
+        EventNotice *evn = bottom.extract_first();
+        append(tmp, evn);
+        ++n;
+    }
+    tmin = static_cast<EventNotice *>(tmp.succ)->time;
+    tmax = static_cast<EventNotice *>(tmp.pred)->time;
+    if(nrungs < LADDER_MAXRUNGS && tmax - tmin > 1e-12 * tmax) {
+        new_rung(tmp, n, tmin, tmax);
+        bottom_limit = LADDER_THRES;
+        fill_bottom();
+    } else {                            // can not refine, keep bottom
+        bucket_to_bottom(tmp);
+        bottom_limit = 2 * n;
+    }
+}
+
+/// schedule entity e at time t
+void CalendarLadder::ScheduleAt(Entity *e, double t)
+{
+    if(t<SIMLIB_Time)
+        SIMLIB_error(SchedulingBeforeTime);
+    EventNotice *evn = EventNotice::Create(e,t);
+    ++_size;
+    if(t >= top_start) {
+        append(top, evn);
+        ++ntop;
+    } else {
+        unsigned i;
+        for(i = 0; i < nrungs; ++i) {   // from the coarsest rung
+            Rung &r = rungs[i];
+            double bi = r.index(t);
+            if(bi >= r.cur && r.cur < r.nbuckets) { // not exhausted rung
+                unsigned b = bi < r.nbuckets ? static_cast<unsigned>(bi) : r.nbuckets - 1;
+                append(r.buckets[b], evn);
+                break;
+            }
+        }
+        if(i == nrungs) {               // nearest future
+            bottom.insert_extracted(evn);
+            if(++nbottom > bottom_limit)
+                spawn_bottom();
+        }
+    }
+    fill_bottom();
+    update_mintime();
+}
+
+/// dequeue first entity
+Entity *CalendarLadder::GetFirst()
+{
+    if(Empty())
+        SIMLIB_error(EmptyCalendar);
+    Entity *e = bottom.remove_first();
+    --_size;
+    if(nbottom > 0) --nbottom;
+    fill_bottom();
+    update_mintime();
+    return e;
+}
+
+/// remove entity e from calendar
+Entity *CalendarLadder::Get(Entity *e)
+{
+    if(Empty())
+        SIMLIB_error(EmptyCalendar);
+    if(e->Idle())
+        SIMLIB_error(EntityIsNotScheduled);
+    if(e->GetEventNotice()->time >= top_start)
+        --ntop;
+    EventNotice::Destroy(e->GetEventNotice());  // unlink from any list
+    --_size;
+    fill_bottom();
+    update_mintime();
+    return e;
+}
+
+/// remove all event notices, and optionally destroy entities
+void CalendarLadder::clear(bool destroy)
+{
+    Dprintf(("CalendarLadder::clear(destroy=%s)", destroy?"true":"false"));
+    bottom.clear(destroy);
+    for(unsigned i = 0; i < nrungs; ++i) {
+        Rung &r = rungs[i];
+        for(unsigned b = 0; b < r.nbuckets; ++b)
+            while(!bucket_empty(r.buckets[b])) {
+                Entity *e = static_cast<EventNotice *>(r.buckets[b].succ)->entity;
+                EventNotice::Destroy(e->GetEventNotice());
+                if(destroy && e->isAllocated()) delete e;
+            }
+        delete [] r.buckets;
+    }
+    nrungs = 0;
+    while(!bucket_empty(top)) {
+        Entity *e = static_cast<EventNotice *>(top.succ)->entity;
+        EventNotice::Destroy(e->GetEventNotice());
+        if(destroy && e->isAllocated()) delete e;
+    }
+    ntop = 0;
+    top_start = SIMLIB_MINTIME;
+    nbottom = 0;
+    bottom_limit = LADDER_THRES;
+    _size = 0;
+    SetMinTime(SIMLIB_MAXTIME);
+}
+
+
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////
@@ -1166,6 +1776,31 @@ void CalendarQueue::debug_print() // print of calendar queue contents
   Print("\n");
 }
 ////////////////////////////////////////////////////////////////////////////
+void CalendarHeap::debug_print() // print of heap contents
+{
+  Print("CalendarHeap:\n");
+  for(unsigned i=0; i<heap.size(); i++) {
+    Print("  [%03u]:", i );
+    Print("\t %s", heap[i].evn->entity->Name().c_str() );
+    Print("\t at=%g", heap[i].time );
+    Print("\n");
+  }
+  if(heap.empty())
+      Print("  <empty>\n");
+  Print("\n");
+}
+////////////////////////////////////////////////////////////////////////////
+void CalendarLadder::debug_print() // print of ladder queue contents
+{
+  Print("CalendarLadder: top=%u (>= %g), rungs=%u\n", ntop, top_start, nrungs);
+  for(unsigned i=0; i<nrungs; i++)
+      Print(" rung#%u: start=%g, width=%g, buckets=%u, current=%u\n",
+            i, rungs[i].start, rungs[i].width, rungs[i].nbuckets, rungs[i].cur);
+  Print(" bottom:\n");
+  bottom.debug_print();
+  Print("\n");
+}
+////////////////////////////////////////////////////////////////////////////
 /// CalendarQueue::visualize -- output suitable for Gnuplot
 void CalendarQueue::visualize(const char *msg)
 {
@@ -1197,30 +1832,33 @@ void CalendarQueue::visualize(const char *msg)
 
 ////////////////////////////////////////////////////////////////////////////
 
-/// static pointer to singleton instance
-Calendar * Calendar::_instance = 0;
-
 /// interface to singleton instance
 inline Calendar * Calendar::instance() {
-  if(_instance==0) {
+  Calendar *&cal = SIMLIB_state.calendar;
+  if(cal==0) {
 #if 1 // choose default
-      _instance = CalendarList::create(); // create default calendar
+      cal = CalendarList::create(); // create default calendar
 #else
-      _instance = CalendarQueue::create(); // create default calendar
+      cal = CalendarQueue::create(); // create default calendar
 #endif
   }
-  return _instance;
+  return cal;
 }
 
 /// destroy single instance
 void Calendar::delete_instance() {
     Dprintf(("Calendar::delete_instance()"));
-    if(_instance) {
-        delete _instance;           // remove all, free
-        _instance = 0;
+    if(SIMLIB_state.calendar) {
+        delete SIMLIB_state.calendar; // remove all, free
+        SIMLIB_state.calendar = 0;
     }
 }
 
+/// destroy calendar of the active context (used by SimulationContext)
+void SIMLIB_CalendarDelete() {
+    Calendar::delete_instance();
+}
+
 
 #if 0
 class Calendars {
@@ -1245,22 +1883,42 @@ class Calendars {
 };
 #endif
 
+/// table of calendar implementations
+/// first item is the default
+static const struct {
+    const char *name;               //!< name used in SetCalendar
+    Calendar *(*create)();          //!< factory
+} calendars[] = {
+    { "list",   []() -> Calendar * { return CalendarList::create(); } },
+    { "cq",     []() -> Calendar * { return CalendarQueue::create(); } },
+    { "heap",   []() -> Calendar * { return CalendarHeap::create(); } },
+    { "ladder", []() -> Calendar * { return CalendarLadder::create(); } },
+};
+static const unsigned ncalendars = sizeof(calendars) / sizeof(calendars[0]);
+
 /// choose calendar implementation
 /// default is list
 void SetCalendar(const char *name) {
-  if( SIMLIB_Phase == INITIALIZATION ||
-      SIMLIB_Phase == SIMULATION ) SIMLIB_error("SetCalendar() can't be used after Init()");
+  if( Phase == INITIALIZATION ||
+      Phase == SIMULATION ) SIMLIB_error("SetCalendar() can't be used after Init()");
 
-    if(Calendar::_instance) // already initialized
+    if(SIMLIB_state.calendar) // already initialized
         Calendar::delete_instance();
-    if(name==0 || std::strcmp(name,"")==0 || std::strcmp(name,"default")==0)
-        Calendar::_instance = CalendarList::create();
-    else if(std::strcmp(name,"list")==0)
-        Calendar::_instance = CalendarList::create();
-    else if(std::strcmp(name,"cq")==0)
-        Calendar::_instance = CalendarQueue::create();
-    else
-        SIMLIB_error("SetCalendar: bad argument");
+    if(name==0 || std::strcmp(name,"")==0 || std::strcmp(name,"default")==0) {
+        SIMLIB_state.calendar = calendars[0].create();
+        return;
+    }
+    for(unsigned i=0; i<ncalendars; i++)
+        if(std::strcmp(name,calendars[i].name)==0) {
+            SIMLIB_state.calendar = calendars[i].create();
+            return;
+        }
+    SIMLIB_error("SetCalendar: bad argument");
+}
+
+/// name of i-th calendar implementation, 0 if there is no such
+const char *CalendarName(unsigned i) {
+    return i < ncalendars ? calendars[i].name : 0;
 }
 
 
@@ -1301,7 +1959,7 @@ cal_cost_op = "enqueue";
 OP_MEASURE=0;
 //  if(Calendar::instance()->size() < 300) Calendar::instance()->visualize("");
 #endif
-  _SetTime(NextTime, Calendar::instance()->MinTime());
+  _SetTime(SIMLIB_NextTime, Calendar::instance()->MinTime());
 }
 
 /// remove selected entity activation record from calendar
@@ -1319,7 +1977,7 @@ cal_cost_flag = OP_MEASURE;
 cal_cost_op = "delete";
 OP_MEASURE=0;
 #endif
-  _SetTime(NextTime, Calendar::instance()->MinTime());
+  _SetTime(SIMLIB_NextTime, Calendar::instance()->MinTime());
 }
 
 /// remove entity with minimum activation time
@@ -1338,14 +1996,14 @@ cal_cost_flag = OP_MEASURE;
 cal_cost_op = "dequeue";
 OP_MEASURE=0;
 #endif
-  _SetTime(NextTime, Calendar::instance()->MinTime());
+  _SetTime(SIMLIB_NextTime, Calendar::instance()->MinTime());
   return ret;
 }
 
 /// remove all scheduled entities
 void SQS::Clear() {                       // remove all
   Calendar::instance()->clear(true);
-  _SetTime(NextTime, Calendar::instance()->MinTime());
+  _SetTime(SIMLIB_NextTime, Calendar::instance()->MinTime());
 }
 
 int SQS::debug_print() {                 // for debugging only
@@ -0,0 +1,227 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file context.cc  Global state of simulation experiment
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+// SIMLIB global variables and class SimulationContext
+//
+// All variables of simulation experiment are thread_local, so each thread
+// runs its own experiment. SimulationContext keeps the state of inactive
+// experiment, Select() exchanges it with the variables of the thread.
+//
+
+#include "simlib.h"
+#include "internal.h"
+
+
+////////////////////////////////////////////////////////////////////////////
+// implementation
+//
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+////////////////////////////////////////////////////////////////////////////
+//  SIMLIB global variables
+//
+//  SIMLIB_*  --- internal variables
+//  [A-Z]*    --- user-level read-only references to them
+//
+//  initial values are constant: no dynamic initialization of SIMLIB_*
+//  thread-local variables (they can be used at exit)
+
+// time-related variables
+// ASSERTION: StartTime <= Time <= NextTime <= EndTime
+SIMLIB_THREAD_LOCAL double SIMLIB_StartTime;   // time of simulation start
+SIMLIB_THREAD_LOCAL double SIMLIB_Time;        // simulation time
+SIMLIB_THREAD_LOCAL double SIMLIB_NextTime;    // next-event time
+SIMLIB_THREAD_LOCAL double SIMLIB_EndTime;     // time of simulation end
+
+// current entity pointer
+SIMLIB_THREAD_LOCAL Entity *SIMLIB_Current = nullptr;
+
+// phase of simulation experiment
+SIMLIB_THREAD_LOCAL SIMLIB_Phase_t Phase = START;
+
+// step limits of numerical integration method
+SIMLIB_THREAD_LOCAL double SIMLIB_OptStep;            // optimal step
+SIMLIB_THREAD_LOCAL double SIMLIB_MinStep = 1e-10;    // minimal step
+SIMLIB_THREAD_LOCAL double SIMLIB_MaxStep = 1;        // max. step
+SIMLIB_THREAD_LOCAL double SIMLIB_StepSize;           // actual step
+
+// error params
+SIMLIB_THREAD_LOCAL double SIMLIB_AbsoluteError = 0;      // absolute error
+SIMLIB_THREAD_LOCAL double SIMLIB_RelativeError = 0.001;  // relative error
+
+// read-only references for models, bound in each thread to its variables
+thread_local const double & StartTime = SIMLIB_StartTime;
+thread_local const double & Time      = SIMLIB_Time;
+thread_local const double & NextTime  = SIMLIB_NextTime;
+thread_local const double & EndTime   = SIMLIB_EndTime;
+thread_local Entity *const & Current  = SIMLIB_Current;
+thread_local const double & OptStep   = SIMLIB_OptStep;
+thread_local const double & MinStep   = SIMLIB_MinStep;
+thread_local const double & MaxStep   = SIMLIB_MaxStep;
+thread_local const double & StepSize  = SIMLIB_StepSize;
+thread_local const double & AbsoluteError = SIMLIB_AbsoluteError;
+thread_local const double & RelativeError = SIMLIB_RelativeError;
+
+// internal statistics
+SIMLIB_THREAD_LOCAL SIMLIB_statistics_t SIMLIB_statistics;
+
+// the rest of experiment state (calendar, hooks, ...)
+SIMLIB_THREAD_LOCAL SIMLIB_State SIMLIB_state;
+
+
+////////////////////////////////////////////////////////////////////////////
+/// saved state of inactive SimulationContext
+/// <br> initial values are the same as for the variables above
+struct SimulationContext::Data {
+    double StartTime = 0;
+    double Time = 0;
+    double NextTime = 0;
+    double EndTime = 0;
+    Entity *Current = nullptr;
+    SIMLIB_Phase_t Phase = START;
+    double OptStep = 0;
+    double MinStep = 1e-10;
+    double MaxStep = 1;
+    double StepSize = 0;
+    double AbsoluteError = 0;
+    double RelativeError = 0.001;
+    double StepStartTime = 0;
+    double DeltaTime = 0;
+    SIMLIB_statistics_t statistics;
+    SIMLIB_State state;
+    bool selected = false;              // active in some thread
+
+    /// store variables of current thread
+    void save() {
+        StartTime = SIMLIB_StartTime;
+        Time = SIMLIB_Time;
+        NextTime = SIMLIB_NextTime;
+        EndTime = SIMLIB_EndTime;
+        Current = SIMLIB_Current;
+        Phase = simlib3::Phase;
+        OptStep = SIMLIB_OptStep;
+        MinStep = SIMLIB_MinStep;
+        MaxStep = SIMLIB_MaxStep;
+        StepSize = SIMLIB_StepSize;
+        AbsoluteError = SIMLIB_AbsoluteError;
+        RelativeError = SIMLIB_RelativeError;
+        StepStartTime = SIMLIB_StepStartTime;
+        DeltaTime = SIMLIB_DeltaTime;
+        statistics = SIMLIB_statistics;
+        state = SIMLIB_state;
+    }
+    /// restore variables of current thread
+    void load() const {
+        SIMLIB_StartTime = StartTime;
+        SIMLIB_Time = Time;
+        SIMLIB_NextTime = NextTime;
+        SIMLIB_EndTime = EndTime;
+        SIMLIB_Current = Current;
+        simlib3::Phase = Phase;
+        SIMLIB_OptStep = OptStep;
+        SIMLIB_MinStep = MinStep;
+        SIMLIB_MaxStep = MaxStep;
+        SIMLIB_StepSize = StepSize;
+        SIMLIB_AbsoluteError = AbsoluteError;
+        SIMLIB_RelativeError = RelativeError;
+        SIMLIB_StepStartTime = StepStartTime;
+        SIMLIB_DeltaTime = DeltaTime;
+        SIMLIB_statistics = statistics;
+        SIMLIB_state = state;
+    }
+};
+
+// active context of the thread, 0 if the default one
+SIMLIB_THREAD_LOCAL SimulationContext *SimulationContext::active = nullptr;
+// saved state of default context of the thread (if not active)
+SIMLIB_THREAD_LOCAL SimulationContext::Data *SimulationContext::default_data = nullptr;
+
+////////////////////////////////////////////////////////////////////////////
+/// create context in the state of program start (no calendar, ...)
+SimulationContext::SimulationContext() : data(new Data)
+{
+    Dprintf(("SimulationContext::SimulationContext()"));
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// destroy context: all scheduled and waiting entities are deleted
+/// <br> the previously active context stays active
+SimulationContext::~SimulationContext()
+{
+    Dprintf(("SimulationContext::~SimulationContext()"));
+    SimulationContext *previous = (active == this) ? nullptr : active;
+    Select();
+    if (Phase == SIMULATION)
+        SIMLIB_error("SimulationContext can't be destroyed inside Run()");
+    SIMLIB_WUDelete();
+    SIMLIB_CalendarDelete();
+    if (previous)
+        previous->Select();
+    else
+        SelectDefault();
+    delete data;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// check if the active context can be changed
+static void CheckSwitch()
+{
+    if (Phase == SIMULATION)
+        SIMLIB_error("SimulationContext can't be changed inside Run()");
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// make this context active in current thread
+/// <br> the state of previously active context is saved
+void SimulationContext::Select()
+{
+    if (active == this)
+        return;
+    if (data->selected)
+        SIMLIB_error("SimulationContext is active in other thread");
+    CheckSwitch();
+    if (active) {
+        active->data->save();
+        active->data->selected = false;
+    } else {
+        if (default_data == nullptr)
+            default_data = new Data;
+        default_data->save();
+    }
+    data->load();
+    data->selected = true;
+    active = this;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// make the default context of current thread active
+void SimulationContext::SelectDefault()
+{
+    if (active == nullptr)
+        return;
+    CheckSwitch();
+    active->data->save();
+    active->data->selected = false;
+    default_data->load();
+    delete default_data;
+    default_data = nullptr;
+    active = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// active context of current thread, 0 if it is the default one
+SimulationContext *SimulationContext::Active()
+{
+    return active;
+}
+
+} // namespace
+
+// end
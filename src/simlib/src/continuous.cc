@@ -266,7 +266,7 @@ Input operator - (Input a) { return new _UMinus(a); }
 class _Time: public aContiBlock {
  public:
   _Time() {}
-  virtual double Value () override { return Time; }
+  virtual double Value () override { return SIMLIB_Time; }
   virtual std::string Name() const override { return "T(Time)"; }
 };
 
@@ -0,0 +1,273 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file coprocess.h   processes implemented by C++20 coroutines
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+//  This is the interface for CoProcess --- alternative to Process
+//
+//  Behavior() is C++20 coroutine, blocking operations are awaitables:
+//
+//      CoBehavior Behavior() override {
+//          co_await Seize(f);
+//          co_await Wait(Exponential(10));
+//          Release(f);
+//      }
+//
+//  Coroutine frame is on heap (frame arena), so there is no restriction
+//  on pointers to locals and no stack size limit. Suspension and resumption
+//  does not copy any data. Process and CoProcess can be used together
+//  in single model (both are entities).
+//
+//  WARNING: blocking operation without co_await does not suspend
+//           the behavior ([[nodiscard]] warning)
+//
+//  Requires C++20 (-std=c++20), this header is not used by the library itself.
+//
+
+#ifndef __SIMLIB__
+#   error "coprocess.h: you must include simlib.h first"
+#endif
+#if __cplusplus < 202002L
+#   error "coprocess.h: requires C++20 coroutines (use -std=c++20)"
+#endif
+
+#ifndef __SIMLIB_COPROCESS_H
+#define __SIMLIB_COPROCESS_H
+
+#include <coroutine>
+#include <cstddef>
+#include <new>
+#include <string>
+
+namespace simlib3 {
+
+////////////////////////////////////////////////////////////////////////////
+//! Allocator of coroutine frames of CoProcess::Behavior()
+//! Frames are rounded up to size classes (64 B) and recycled in free lists,
+//! new blocks are cut from 64 KiB chunks. Large frames use operator new.
+//! There is one arena per thread (as simulation context), its chunks are
+//! freed at thread exit. Frames still allocated then (processes destroyed
+//! later, e.g. by static objects at program exit) keep the chunks until
+//! the last of them is freed.
+class CoFrameArena {
+    static constexpr std::size_t GRANULE = 64;          //!< size class step
+    static constexpr std::size_t MAX_SIZE = 4096;       //!< larger -> new
+    static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+    struct FreeBlock { FreeBlock *next; };
+    struct Chunk { Chunk *next; };                      //!< chunk header
+    FreeBlock *free_list[MAX_SIZE / GRANULE + 1] = {};  //!< per size class
+    Chunk *chunks = nullptr;            //!< list of all chunks
+    char *chunk_ptr = nullptr;          //!< unused part of current chunk
+    char *chunk_end = nullptr;
+    std::size_t live = 0;               //!< number of allocated frames
+    std::size_t reserved = 0;           //!< bytes in chunks
+    bool closed = false;                //!< thread exit: free when live == 0
+    static std::size_t SizeClass(std::size_t sz) {
+        return (sz + GRANULE - 1) / GRANULE;
+    }
+    void FreeChunks() noexcept {
+        while (Chunk *c = chunks) {
+            chunks = c->next;
+            ::operator delete(c);
+        }
+        for (FreeBlock *&b : free_list)
+            b = nullptr;
+        chunk_ptr = chunk_end = nullptr;
+        reserved = 0;
+    }
+    CoFrameArena() = default;
+    ~CoFrameArena() {
+        closed = true;
+        if (live == 0)
+            FreeChunks();
+    }
+  public:
+    CoFrameArena(const CoFrameArena&) = delete;
+    CoFrameArena &operator=(const CoFrameArena&) = delete;
+    //! arena of the thread
+    static CoFrameArena &Instance() {
+        static thread_local CoFrameArena arena;
+        return arena;
+    }
+    void *Allocate(std::size_t sz) {
+        ++live;
+        if (sz > MAX_SIZE)
+            return ::operator new(sz);
+        const std::size_t c = SizeClass(sz);
+        if (FreeBlock *b = free_list[c]) {
+            free_list[c] = b->next;
+            return b;
+        }
+        const std::size_t bytes = c * GRANULE;
+        if (chunk_ptr == nullptr || std::size_t(chunk_end - chunk_ptr) < bytes) {
+            Chunk *chunk = static_cast<Chunk*>(::operator new(CHUNK_SIZE));
+            chunk->next = chunks;
+            chunks = chunk;
+            chunk_ptr = reinterpret_cast<char*>(chunk) + GRANULE; // aligned
+            chunk_end = reinterpret_cast<char*>(chunk) + CHUNK_SIZE;
+            reserved += CHUNK_SIZE;
+        }
+        void *p = chunk_ptr;
+        chunk_ptr += bytes;
+        return p;
+    }
+    void Free(void *p, std::size_t sz) noexcept {
+        --live;
+        if (sz > MAX_SIZE)
+            ::operator delete(p);
+        else {
+            const std::size_t c = SizeClass(sz);
+            FreeBlock *b = static_cast<FreeBlock*>(p);
+            b->next = free_list[c];
+            free_list[c] = b;
+        }
+        if (closed && live == 0)        // last frame after thread exit
+            FreeChunks();
+    }
+    std::size_t LiveFrames() const { return live; }         //!< frames in use
+    std::size_t ReservedBytes() const { return reserved; }  //!< chunk memory
+};
+
+////////////////////////////////////////////////////////////////////////////
+//! Return type of CoProcess::Behavior() (coroutine handle owner)
+class CoBehavior {
+  public:
+    struct promise_type {
+        CoBehavior get_return_object() {
+            return CoBehavior(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; } // started by _Run
+        std::suspend_always final_suspend() noexcept { return {}; }   // destroyed by _Run
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept {
+            Error("CoProcess::Behavior(): unhandled exception");
+        }
+        static void *operator new(std::size_t sz) {
+            return CoFrameArena::Instance().Allocate(sz);
+        }
+        static void operator delete(void *p, std::size_t sz) noexcept {
+            CoFrameArena::Instance().Free(p, sz);
+        }
+    };
+    CoBehavior(CoBehavior &&b) noexcept : handle(b.handle) { b.handle = nullptr; }
+    CoBehavior(const CoBehavior&) = delete;
+    CoBehavior &operator=(const CoBehavior&) = delete;
+    ~CoBehavior() { if (handle) handle.destroy(); }
+    //! pass the ownership of coroutine to caller
+    std::coroutine_handle<> Release() {
+        std::coroutine_handle<> h = handle;
+        handle = nullptr;
+        return h;
+    }
+  private:
+    explicit CoBehavior(std::coroutine_handle<promise_type> h) : handle(h) {}
+    std::coroutine_handle<promise_type> handle;
+};
+
+////////////////////////////////////////////////////////////////////////////
+//! Abstract base class for processes with coroutine Behavior()
+//! @ingroup process
+class CoProcess : public Entity {
+    std::coroutine_handle<> _handle;    //!< suspended Behavior() coroutine
+    enum CoProcessStatus_t {
+        _PREPARED=1, _RUNNING, _INTERRUPTED, _TERMINATED
+    } _status;
+    void _Run() noexcept override;      // internal point of activation
+    void _Remove() {                    // remove from queue and calendar
+        if (Where() != 0)
+            Out();
+        Entity::Passivate();
+    }
+  public:
+    //! awaitable result of blocking operation
+    struct Suspend {
+        bool suspend;                   //!< process is waiting
+        bool await_ready() const noexcept { return !suspend; }
+        void await_suspend(std::coroutine_handle<>) const noexcept {}
+        void await_resume() const noexcept {}
+    };
+    struct AwaitTag {};                 //!< distinguishes awaitable Passivate
+
+    CoProcess(Priority_t p=DEFAULT_PRIORITY) : Entity(p), _status(_PREPARED) {}
+    virtual ~CoProcess() {
+        _status = _TERMINATED;
+        if (_handle)
+            _handle.destroy();          // frame locals are destroyed
+        _Remove();
+    }
+    virtual CoBehavior Behavior() = 0;  //!< behavior description (coroutine)
+    virtual std::string Name() const override {
+        const std::string name = SimObject::Name();
+        return name.empty() ? "CoProcess#" + std::to_string(id()) : name;
+    }
+    bool isCurrent() const { return _status == _RUNNING; } //!< Behavior() runs
+
+    //! wait for dtime interval: co_await Wait(dt)
+    [[nodiscard]] Suspend Wait(double dtime) {
+        Entity::Activate(Time + dtime);
+        return Suspend{isCurrent()};
+    }
+    //! process deactivation: co_await Passivate()
+    [[nodiscard]] Suspend Passivate(AwaitTag = AwaitTag()) {
+        Entity::Passivate();
+        return Suspend{isCurrent()};
+    }
+    //! seize facility: co_await Seize(f)
+    [[nodiscard]] Suspend Seize(Facility &f, ServicePriority_t sp=0) {
+        f.Seize(this, sp);
+        return Suspend{Where() != 0};   // waiting in facility queue
+    }
+    void Release(Facility &f) { f.Release(this); }  //!< release facility
+    //! acquire capacity of store: co_await Enter(s, cap)
+    [[nodiscard]] Suspend Enter(Store &s, unsigned long cap=1) {
+        s.Enter(this, cap);
+        return Suspend{Where() != 0};   // waiting in store queue
+    }
+    void Leave(Store &s, unsigned long cap=1) { s.Leave(cap); } //!< return capacity
+    using Entity::Into;
+    //! insert process into queue (use co_await Passivate() to wait there)
+    void Into(Queue &q) {
+        if (Where() != 0)
+            Out();
+        q.Insert(this);
+    }
+    //! kill process; Behavior() of current process should co_return after it
+    virtual void Terminate() override {
+        _Remove();
+        if (isCurrent()) {              // finished by _Run
+            _status = _TERMINATED;
+            return;
+        }
+        _status = _TERMINATED;
+        if (isAllocated())
+            delete this;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////
+/// Dispatch method: start or resume Behavior() up to next suspension
+inline void CoProcess::_Run() noexcept
+{
+    if (_status != _INTERRUPTED && _status != _PREPARED)
+        Error("CoProcess#%lu: not prepared for running", id());
+    if (!_handle)
+        _handle = Behavior().Release();     // created suspended
+    _status = _RUNNING;
+    _handle.resume();
+    if (_handle.done() || _status == _TERMINATED) {
+        _status = _TERMINATED;
+        _handle.destroy();
+        _handle = nullptr;
+        _Remove();
+        if (isAllocated())
+            delete this;
+        return;
+    }
+    _status = _INTERRUPTED;
+}
+
+} // namespace
+
+#endif // __SIMLIB_COPROCESS_H
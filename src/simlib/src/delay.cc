@@ -177,7 +177,7 @@ class SIMLIB_DelayBuffer : public Delay::Buffer { // memory for delayed signal
 /// initialize and register delay block
 Delay::Delay(Input i, double _dt, double ival) :
     aContiBlock1( i ),                  // input block-expression
-    last_time( Time ),                  // last sample time
+    last_time( SIMLIB_Time ),                  // last sample time
     last_value( ival ),                 // last sample value
     buffer( new SIMLIB_DelayBuffer ),   // allocate delay buffer
     dt( _dt ),                          // Parameter: delay time
@@ -206,7 +206,7 @@ Delay::~Delay()
 /// TODO: evaluate input expression of delay block?
 void Delay::Init() {
     buffer->clear();                    // empty buffer
-    buffer->put( last_value=initval, last_time=Time );  // set initial value
+    buffer->put( last_value=initval, last_time=SIMLIB_Time );  // set initial value
 }
 
 
@@ -215,7 +215,7 @@ void Delay::Init() {
 void Delay::Sample()
 {
     Dprintf(("Delay::Sample()"));
-    buffer->put( InputValue(), Time );  // store into buffer
+    buffer->put( InputValue(), SIMLIB_Time );  // store into buffer
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -223,7 +223,7 @@ void Delay::Sample()
 double Delay::Value()
 {
     Dprintf(("Delay::Value()"));
-    double oldtime = Time - dt;         // past time
+    double oldtime = SIMLIB_Time - dt;         // past time
     if( last_time != oldtime ) {        // is not already computed?
         last_value = buffer->get( oldtime );    // get delayed value
         last_time = oldtime;
@@ -239,7 +239,7 @@ double Delay::Value()
 double Delay::Set(double newdelay)
 {
    double last = dt;
-   if( newdelay>=0.0 && newdelay<=Time )  // FIXME: condition is too weak ###
+   if( newdelay>=0.0 && newdelay<=SIMLIB_Time )  // FIXME: condition is too weak ###
       dt = newdelay;
    return last;
 }
@@ -23,15 +23,14 @@ namespace simlib3 {
 
 SIMLIB_IMPLEMENTATION;
 
-/// current number of entities in model
-static unsigned long SIMLIB_Entity_Count = 0L; // # of entities in model
-/// serial number of created entity
-unsigned long Entity::_Number = 0L;     // # of entity creations
+/// serial number of created entity is SIMLIB_state.EntityCount (per context)
+/// current number of entities in model (per thread)
+SIMLIB_THREAD_LOCAL unsigned long Entity::_Number = 0L;
 
 ////////////////////////////////////////////////////////////////////////////
 ///  constructor
 Entity::Entity(Priority_t p) :
-  _Ident(SIMLIB_Entity_Count++), // unique identification
+  _Ident(SIMLIB_state.EntityCount++), // unique identification
   _MarkTime(0.0),
   _SPrio(0),
   Priority(p),
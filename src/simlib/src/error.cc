@@ -37,9 +37,9 @@ SIMLIB_IMPLEMENTATION;
 /// print error message and abort program
 void SIMLIB_error(const enum _ErrEnum N)
 {
-  _Print(_ERR_TXT, (double)Time, _ErrMsg(N));
+  _Print(_ERR_TXT, (double)SIMLIB_Time, _ErrMsg(N));
   _Print(_ABORT_TXT);
-  SIMLIB_Phase = ERROREXIT;
+  Phase = ERROREXIT;
   SIMLIB_DynamicFlag = false;
   exit(3);
 }
@@ -52,7 +52,7 @@ void SIMLIB_error(const char *fmt, ... )
   va_start(argptr, fmt);
   vsnprintf(s, sizeof(s), fmt, argptr);
   va_end(argptr);
-  _Print(_ERR_TXT, (double)Time, s);
+  _Print(_ERR_TXT, (double)SIMLIB_Time, s);
   _Print(_ABORT_TXT);
   exit(1);
 }
@@ -60,11 +60,11 @@ void SIMLIB_error(const char *fmt, ... )
 /// print error message and abort program
 void SIMLIB_error(const char*filename, const int linenum)
 {
-  _Print(_INT_ERR_TXT, (double)Time,
+  _Print(_INT_ERR_TXT, (double)SIMLIB_Time,
                        _ErrMsg(InternalError),
                        filename, linenum);
   _Print(_ABORT_TXT);
-  SIMLIB_Phase = ERROREXIT;
+  Phase = ERROREXIT;
   SIMLIB_DynamicFlag = false; // if in continuous simulation algorithm
   exit(3);
 }
@@ -73,7 +73,7 @@ void SIMLIB_error(const char*filename, const int linenum)
 /// print warning message and continue
 void SIMLIB_warning( const enum _ErrEnum N )
 {
-  _Print(_WARNING_TXT, (double)Time, _ErrMsg(N));
+  _Print(_WARNING_TXT, (double)SIMLIB_Time, _ErrMsg(N));
 }
 
 /// print warning message and continue
@@ -83,7 +83,7 @@ void SIMLIB_warning(const char *fmt, ... )
   va_list argptr;
   va_start(argptr, fmt);
   vsnprintf(s, sizeof(s), fmt, argptr);
-  _Print(_ERR_TXT, (double)Time, s);
+  _Print(_ERR_TXT, (double)SIMLIB_Time, s);
   va_end(argptr);
 }
 
@@ -31,63 +31,70 @@ enum _ErrEnum {
 /* 21 */ ProcessNotInitialized,
 /* 22 */ HistoStepError,
 /* 23 */ HistoCountError,
-/* 24 */ ListActivityError,
-/* 25 */ ListEmptyError,
-/* 26 */ QueueRefError,
-/* 27 */ EmptyWUListError,
-/* 28 */ EntityRefError,
-/* 29 */ EntityIsNotScheduled,
-/* 30 */ TStatNotInitialized,
-/* 31 */ CantCreateIntg,
-/* 32 */ CantDestroyIntg,
-/* 33 */ CantCreateStatus,
-/* 34 */ CantDestroyStatus,
-/* 35 */ FacInterruptError,
-/* 36 */ ReleaseError,
-/* 37 */ ReleaseNotSeized,
-/* 38 */ EnterCapError,
-/* 39 */ LeaveManyError,
-/* 40 */ SetCapacityError,
-/* 41 */ SetQueueError,
-/* 42 */ WeibullError,
-/* 43 */ ErlangError,
-/* 44 */ NegBinError,
-/* 45 */ NegBinMError1,
-/* 46 */ NegBinMError2,
-/* 47 */ PoissonError,
-/* 48 */ GeomError,
-/* 49 */ HyperGeomError1,
-/* 50 */ HyperGeomError2,
-/* 51 */ OutFilePutError,
-/* 52 */ OutFileOpenError,
-/* 53 */ CantOpenOutFile,
-/* 54 */ CantCloseOutFile,
-/* 55 */ AlgLoopDetected,
-/* 56 */ LowGreaterHigh,
-/* 57 */ BadQntzrStep,
-/* 58 */ InconsistentHeader,
-/* 59 */ SemaphoreError,
-/* 60 */ BadUniformParam,
-/* 61 */ StatNoRecError,
-/* 62 */ StatDispError,
-/* 63 */ AL_BadBounds,
-/* 64 */ AL_BadInitVal,
-/* 65 */ AL_Diverg,
-/* 66 */ AL_MaxCount,
-/* 67 */ AL_NotInLoop,
-/* 68 */ NI_UnknownMeth,
-/* 69 */ NI_MultDefMeth,
-/* 70 */ NI_IlStepSize,
-/* 71 */ NI_NotSingleStep,
-/* 72 */ NI_NotMultiStep,
-/* 73 */ NI_CantSetMethod,
-/* 74 */ NI_CantSetStarter,
-/* 75 */ RlineErr1,
-/* 76 */ RlineErr2,
-/* 77 */ NoDebugErr,
-/* 78 */ DelayTimeErr,
-/* 79 */ ParameterChangeErr,
-/* 80 */ UserError,
+/* 24 */ QuantileInitError,
+/* 25 */ QuantileMergeError,
+/* 26 */ QuantileProbError,
+/* 27 */ QuantileNoRecError,
+/* 28 */ ListActivityError,
+/* 29 */ ListEmptyError,
+/* 30 */ QueueRefError,
+/* 31 */ EmptyWUListError,
+/* 32 */ EntityRefError,
+/* 33 */ EntityIsNotScheduled,
+/* 34 */ TStatNotInitialized,
+/* 35 */ CantCreateIntg,
+/* 36 */ CantDestroyIntg,
+/* 37 */ CantCreateStatus,
+/* 38 */ CantDestroyStatus,
+/* 39 */ FacInterruptError,
+/* 40 */ ReleaseError,
+/* 41 */ ReleaseNotSeized,
+/* 42 */ EnterCapError,
+/* 43 */ LeaveManyError,
+/* 44 */ SetCapacityError,
+/* 45 */ SetQueueError,
+/* 46 */ WeibullError,
+/* 47 */ ErlangError,
+/* 48 */ NegBinError,
+/* 49 */ NegBinMError1,
+/* 50 */ NegBinMError2,
+/* 51 */ PoissonError,
+/* 52 */ BinomError,
+/* 53 */ GeomError,
+/* 54 */ HyperGeomError1,
+/* 55 */ HyperGeomError2,
+/* 56 */ OutFilePutError,
+/* 57 */ OutFileOpenError,
+/* 58 */ CantOpenOutFile,
+/* 59 */ CantCloseOutFile,
+/* 60 */ OutputFormatError,
+/* 61 */ AlgLoopDetected,
+/* 62 */ LowGreaterHigh,
+/* 63 */ BadQntzrStep,
+/* 64 */ InconsistentHeader,
+/* 65 */ SemaphoreError,
+/* 66 */ BadUniformParam,
+/* 67 */ StatNoRecError,
+/* 68 */ StatDispError,
+/* 69 */ StatImageError,
+/* 70 */ AL_BadBounds,
+/* 71 */ AL_BadInitVal,
+/* 72 */ AL_Diverg,
+/* 73 */ AL_MaxCount,
+/* 74 */ AL_NotInLoop,
+/* 75 */ NI_UnknownMeth,
+/* 76 */ NI_MultDefMeth,
+/* 77 */ NI_IlStepSize,
+/* 78 */ NI_NotSingleStep,
+/* 79 */ NI_NotMultiStep,
+/* 80 */ NI_CantSetMethod,
+/* 81 */ NI_CantSetStarter,
+/* 82 */ RlineErr1,
+/* 83 */ RlineErr2,
+/* 84 */ NoDebugErr,
+/* 85 */ DelayTimeErr,
+/* 86 */ ParameterChangeErr,
+/* 87 */ UserError,
 };
 
 extern const char *_ErrMsg(enum _ErrEnum N);
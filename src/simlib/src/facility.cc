@@ -115,7 +115,7 @@ void Facility::Seize(Entity * e, ServicePriority_t sp)
 //
     Dprintf(("%s.Seize(%s,%u)", Name().c_str(), e->Name().c_str(), (unsigned) sp));
     CHECKENTITY(e);
-    if (e != Current)
+    if (e != SIMLIB_Current)
         SIMLIB_error(EntityRefError);
     e->_SPrio = sp;
     if (!Busy()) {
@@ -128,7 +128,7 @@ void Facility::Seize(Entity * e, ServicePriority_t sp)
         if (in->Idle()) // currently serviced entity is not scheduled
             SIMLIB_error(FacInterruptError);
         // compute the remaining service time
-        in->_RemainingTime = in->ActivationTime() - Time;
+        in->_RemainingTime = in->ActivationTime() - SIMLIB_Time;
         QueueIn2(*in);          // insert interrupted entity into queue2
         in->Passivate();        // wait in queue2 =====================
         in = e;                 // seize by entity
@@ -180,7 +180,7 @@ void Facility::Release(Entity * e)
         in = ent;               // seize again
         tstat(1);
         tstat.n--;              // correction !!!
-        ent->Activate(Time + ent->_RemainingTime);  // schedule end of service
+        ent->Activate(SIMLIB_Time + ent->_RemainingTime);  // schedule end of service
         return;
     }
     if (!Q1->empty()) {         // input queue not empty -- seize from Q1
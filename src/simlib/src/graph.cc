@@ -104,9 +104,9 @@ void Graph::Behavior()
   Sample();
 
   if(TimeStep<=0)
-    TimeStep = (double(EndTime)-double(StartTime))/100;
+    TimeStep = (double(SIMLIB_EndTime)-double(SIMLIB_StartTime))/100;
 
-  Activate(double(Time)+double(TimeStep));
+  Activate(double(SIMLIB_Time)+double(TimeStep));
 }
 
 
@@ -120,9 +120,9 @@ void Graph::StartSampling()
   Sample();
 
   if(TimeStep<=0)
-    TimeStep = (double(EndTime)-double(StartTime))/100;
+    TimeStep = (double(SIMLIB_EndTime)-double(SIMLIB_StartTime))/100;
 
-  Activate(double(Time)+double(TimeStep));
+  Activate(double(SIMLIB_Time)+double(TimeStep));
 }
 
 ////////////////////////////////////////////////////////////////////////////
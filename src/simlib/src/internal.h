@@ -81,8 +81,8 @@ enum SIMLIB_Phase_t {
     ERROREXIT       // fatal error handling phase
 };
 //! This variable contains the current phase of experiment
-//! (used for internal checking)
-extern const SIMLIB_Phase_t &Phase;
+//! (used for internal checking, one per thread - see SimulationContext)
+extern SIMLIB_THREAD_LOCAL SIMLIB_Phase_t Phase;
 
 ////////////////////////////////////////////////////////////////////////////
 // debugging ...
@@ -94,7 +94,6 @@ extern const SIMLIB_Phase_t &Phase;
 #   define DEBUG(c,s)
 #   define DEBUG_INFO
 #else
-    extern double SIMLIB_Time;            // simulation time
 #   define DEBUG_INFO "/debug"
     extern unsigned long SIMLIB_debug_flag; // debugging flags
 #   define Dprintf(f) \
@@ -184,9 +183,9 @@ typedef void (*VoidFunctionPtr)(); // ptr to void function
 extern bool SIMLIB_DynamicFlag;             // in dynamic section
 extern bool SIMLIB_ResetStatus;             // restart flag
 
-extern SIMLIB_Phase_t SIMLIB_Phase;         // phase of simulation experiment
-
-extern Entity *SIMLIB_Current;              // currently active entity
+void SIMLIB_ObjectPoolTrim();               // free unused SimObject memory
+void SIMLIB_OutputUnregister(SimObject *o); // destroyed object (OutputStatistics)
+bool SIMLIB_OutputWrite(const std::string &data); // write to output file
 
 extern int SIMLIB_ERRNO;                    // error number
 
@@ -194,23 +193,69 @@ extern bool SIMLIB_ConditionFlag;           // change of condition vector
 extern bool SIMLIB_ContractStepFlag;        // requests shorter step
 extern double SIMLIB_ContractStep;          // requested step size
 
-extern double SIMLIB_StepStartTime;         // last step time
-extern double SIMLIB_DeltaTime;             // Time-s_StepStartTime
+extern SIMLIB_THREAD_LOCAL double SIMLIB_StepStartTime; // last step time
+extern SIMLIB_THREAD_LOCAL double SIMLIB_DeltaTime;     // Time-s_StepStartTime
+
+// time, step and error variables (read-only references in simlib.h)
+extern SIMLIB_THREAD_LOCAL double SIMLIB_StartTime, SIMLIB_Time,
+                                  SIMLIB_NextTime, SIMLIB_EndTime;
+extern SIMLIB_THREAD_LOCAL Entity *SIMLIB_Current;
+extern SIMLIB_THREAD_LOCAL double SIMLIB_MinStep, SIMLIB_StepSize,
+                                  SIMLIB_OptStep, SIMLIB_MaxStep;
+extern SIMLIB_THREAD_LOCAL double SIMLIB_AbsoluteError, SIMLIB_RelativeError;
+
+class Calendar;
+class WaitUntilList;
 
-extern double SIMLIB_OptStep;               // optimal step
-extern double SIMLIB_MinStep;               // minimal step
-extern double SIMLIB_MaxStep;               // max. step
-extern double SIMLIB_StepSize;              // actual step
+double SIMLIB_RandomBase();                 // default base random generator
+const long SIMLIB_RANDOM_INICONST = 1537L;  // its initial seed (random1.cc)
 
-extern double SIMLIB_AbsoluteError;         // absolute error tolerance
-extern double SIMLIB_RelativeError;         // relative error
+////////////////////////////////////////////////////////////////////////////
+//! State of simulation experiment which is not in public variables.
+//! There is one instance per thread (SIMLIB_state), SimulationContext
+//! exchanges it together with public variables (Time, Current, ...).
+//! The constructor is constexpr: thread_local storage is initialized
+//! statically (no initialization on access, usable at exit).
+struct SIMLIB_State {
+    Calendar *calendar;                 // calendar instance (SQS)
+    WaitUntilList *wulist;              // WaitUntil list instance
+    bool StopFlag;                      // if set, stop simulation run
+    unsigned long experiment_no;        // experiment counter (Init)
+    unsigned long EntityCount;          // # of entities created (ids)
+    long RandomSeed;                    // state of base random generator
+    double (*RandomBase)();             // base random generator
+    long RandomStreamSeed;              // last RandomSeed() (RandomStream)
+    unsigned long RandomReplication;    // replication of RandomSeed()
+    unsigned long RandomEpoch;          // unique number of last RandomSeed()
+    RandomStream RandomDefault;         // stream of RandomXoshiro256()
+    RandomStream *RandomActive;         // SetRandomStream(), 0 = RandomDefault
+    bool RandomCompat;                  // old Normal() and Exponential()
+    // hook table (see DEFINE_HOOK)
+    void (*hook_Delay)();               // run.cc: Run(), SampleDelays()
+    void (*hook_DelayInit)();           // Init()
+    void (*hook_ZDelayTimerInit)();     // Run()
+    void (*hook_Break)();               // Run()
+    void (*hook_SamplerAct)();          // Run()
+    void (*hook_SamplerInit)();         // Init()
+    void (*hook_WUclear)();             // Init()
+    void (*hook_WUget_next)();          // SIMLIB_DoActions()
+
+    constexpr SIMLIB_State() :
+        calendar(0), wulist(0), StopFlag(false), experiment_no(0),
+        EntityCount(0), RandomSeed(SIMLIB_RANDOM_INICONST),
+        RandomBase(SIMLIB_RandomBase),
+        RandomStreamSeed(SIMLIB_RANDOM_INICONST), RandomReplication(0),
+        RandomEpoch(1), RandomDefault(), RandomActive(0), RandomCompat(false),
+        hook_Delay(0), hook_DelayInit(0), hook_ZDelayTimerInit(0),
+        hook_Break(0), hook_SamplerAct(0), hook_SamplerInit(0),
+        hook_WUclear(0), hook_WUget_next(0) {}
+};
 
-extern double SIMLIB_StartTime;       // time of simulation start
-extern double SIMLIB_Time;            // simulation time
-extern double SIMLIB_NextTime;        // next-event time
-extern double SIMLIB_EndTime;         // time of simulation end
+//! state of active simulation experiment of the thread
+extern SIMLIB_THREAD_LOCAL SIMLIB_State SIMLIB_state;
 
-// TODO: move to context (public methods with prefix calendar::?)
+void SIMLIB_CalendarDelete();        // destroy calendar (SimulationContext)
+void SIMLIB_WUDelete();              // destroy WaitUntil list (SimulationContext)
 
 //! Special namespace for calendar implementation.
 //!
@@ -225,7 +270,7 @@ namespace SQS {
 };
 
 /// macro for simple assignement to internal time variables
-#define _SetTime(t,x) (SIMLIB_##t = x)
+#define _SetTime(t,x) (t = x)
 
 void SIMLIB_Dynamic();               // TODO: optimize!
 void SIMLIB_DoActions();             // dispatch events and processes
@@ -237,13 +282,13 @@ void SIMLIB_WUClear();               // clear WUList
 //////////////////////////////////////////////////////////////////////////
 // MACROS --- Hooks into simulation control algorithm
 //
-// we use static pointers to void function()
+// we use pointers to void function() in hook table of SIMLIB_State
 // function can be installed by calling INSTALL_HOOK(hook_name,function)
 // used mainly in run.cc
 
 // definition of hook-pointer-variable name and hook-install-function name
 // the names are internal and _can_ be changed here:
-#define HOOK_PTR_NAME(id)  SIMLIB_Hook_Ptr_##id
+#define HOOK_PTR_NAME(id)  SIMLIB_state.hook_##id
 #define HOOK_INST_NAME(id)  SIMLIB_Install_hook_##id
 
 /////////////////////////////////////////////////////////////////////////////
@@ -262,10 +307,9 @@ void SIMLIB_WUClear();               // clear WUList
 // DEFINE_HOOK --- macro for hook definition
 // parameter:
 //      name of hook
-// can be used at global scope
+// can be used at global scope, the hook pointer has to be in SIMLIB_State
 //
 #define DEFINE_HOOK(name)  \
-        static void (* HOOK_PTR_NAME(name) )() = 0; \
         void HOOK_INST_NAME(name)(void (*f)())  { HOOK_PTR_NAME(name) = f; }
 
 
@@ -273,7 +317,7 @@ void SIMLIB_WUClear();               // clear WUList
 // CALL_HOOK --- macro for checked hook calling
 // parameter:
 //      name of hook
-// can be used in the same module as DEFINE_HOOK (static)
+// can be used in any module
 //
 #define CALL_HOOK(name)  \
         if( HOOK_PTR_NAME(name) )  HOOK_PTR_NAME(name) ()
@@ -31,27 +31,10 @@ SIMLIB_IMPLEMENTATION;
 
 int SIMLIB_ERRNO=0;
 
-double SIMLIB_StepStartTime;         //!< last step time
-double SIMLIB_DeltaTime;             //!< Time-SIMLIB_StepStartTime
+SIMLIB_THREAD_LOCAL double SIMLIB_StepStartTime;    //!< last step time
+SIMLIB_THREAD_LOCAL double SIMLIB_DeltaTime;        //!< Time-SIMLIB_StepStartTime
 
-double SIMLIB_OptStep;               //!< optimal step
-double SIMLIB_MinStep=1e-10;         //!< minimal step
-double SIMLIB_MaxStep=1;             //!< max. step
-double SIMLIB_StepSize;              //!< actual step
-
-double SIMLIB_AbsoluteError=0;       //!< absolute error
-double SIMLIB_RelativeError=0.001;   //!< relative error
-
-// step limits
-const double &MinStep=SIMLIB_MinStep;        //!< minimal integration step
-const double &MaxStep=SIMLIB_MaxStep;        //!< maximal integration step
-const double &StepSize=SIMLIB_StepSize;      //!< actual integration step
-const double &OptStep=SIMLIB_OptStep;        //!< optimal integration step
-//const double &StepStartTime=SIMLIB_StepStartTime; // start of step
-
-// error params
-const double &AbsoluteError=SIMLIB_AbsoluteError; //!< max. abs. error of integration
-const double &RelativeError=SIMLIB_RelativeError; //!< max. rel. error
+// step limits and error params (MinStep, ...) are in context.cc
 
 bool SIMLIB_DynamicFlag = false;          //!< in dynamic section
 
@@ -94,7 +77,7 @@ void SetStep(double _dtmin, double _dtmax)
   SIMLIB_MinStep = _dtmin;
   SIMLIB_MaxStep = _dtmax;
   if (SIMLIB_MinStep>SIMLIB_MaxStep) SIMLIB_error(SetStepError);
-//  if (SIMLIB_MinStep/SIMLIB_MaxStep < 1e-12) SIMLIB_error(SetStepError2);
+//  if (MinStep/MaxStep < 1e-12) SIMLIB_error(SetStepError2);
 //  if(MinStep/tend<1e-15) SIMLIB_error(InitMinStepError); // moznost chyby ???
   Dprintf(("SetStep: StepSize = %g .. %g ",SIMLIB_MinStep,SIMLIB_MaxStep));
 }
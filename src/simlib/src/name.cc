@@ -79,7 +79,7 @@ std::string GetName(SimObject * o)
 /// <br> used only for printing
 std::string SIMLIB_create_tmp_name(const char *fmt, ...)
 {
-    static char s[256];
+    char s[256];
     va_list va;
     va_start(va, fmt);
     vsnprintf(s, sizeof(s), fmt, va);
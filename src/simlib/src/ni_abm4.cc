@@ -64,7 +64,7 @@ void ABM4::Integrate(void)
   static int DoubleCount = 0; // number of good steps for doubling stepsize
 
   Dprintf((" ABM4 integration step ")); // print debugging info
-  Dprintf((" Time = %g, optimal step = %g", (double)Time, OptStep));
+  Dprintf((" Time = %g, optimal step = %g", (double)SIMLIB_Time, SIMLIB_OptStep));
 
   //--------------------------------------------------------------------------
   //  Step of method
@@ -79,18 +79,18 @@ begin_step:
 
   if(ABM_Count>0 && PrevStep!=SIMLIB_StepSize) { // stepsize has been changed
     ABM_Count = 0;
-    Dprintf(("NEW START, Time = %g",(double)Time));
+    Dprintf(("NEW START, Time = %g",(double)SIMLIB_Time));
   }
   PrevStep = SIMLIB_StepSize;
 
-  Dprintf(("counter: %d, Time = %g",ABM_Count,(double)Time));
+  Dprintf(("counter: %d, Time = %g",ABM_Count,(double)SIMLIB_Time));
 
     //-----------------------------------------------------------------------
     //  method must be started
     //-----------------------------------------------------------------------
 
   if(ABM_Count <= abm_ord-2) {
-    Dprintf(("start, step = %g, Time = %g",SIMLIB_StepSize,(double)Time));
+    Dprintf(("start, step = %g, Time = %g",SIMLIB_StepSize,(double)SIMLIB_Time));
     ind = 0;
     DoubleCount = 0;
     for(ip=FirstIntegrator(),i=0; ip!=end_it; ip++,i++) {
@@ -107,7 +107,7 @@ begin_step:
     SIMLIB_ContractStepFlag = false; // clear reduce step flag
     SIMLIB_ContractStep = 0.5*SIMLIB_StepSize; // reduce to quater of step
     Dprintf(("own-method, step = %g, Time = %g",
-             SIMLIB_StepSize,(double)Time));
+             SIMLIB_StepSize,(double)SIMLIB_Time));
 
     //-----------------------------------------------------------------------
     //  compute predictor
@@ -126,8 +126,8 @@ begin_step:
                   );
     }
 
-    _SetTime(Time,SIMLIB_StepStartTime + SIMLIB_StepSize); // endpoint time
-    SIMLIB_DeltaTime = double(Time) - SIMLIB_StepStartTime;
+    _SetTime(SIMLIB_Time,SIMLIB_StepStartTime + SIMLIB_StepSize); // endpoint time
+    SIMLIB_DeltaTime = double(SIMLIB_Time) - SIMLIB_StepStartTime;
     SIMLIB_Dynamic();  // evaluate new state of model
     ind=(ind+1)%abm_ord; // increment base index
 
@@ -176,7 +176,7 @@ begin_step:
         if(SIMLIB_ConditionFlag) // event was in half step, step reducing was
           break;                 // unpossible and accuracy cannot be achieved
       }
-      DoubleStepFlag = false;    // disable increasing SIMLIB_OptStep,
+      DoubleStepFlag = false;    // disable increasing OptStep,
     }                            // accuracy is sufficient, but not well
     if(SIMLIB_ERRNO) {
       SIMLIB_warning(AccuracyError);
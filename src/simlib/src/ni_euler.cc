@@ -52,7 +52,7 @@ void EULER::Integrate(void)
   static bool DoubleStepFlag; // flag - allow increasing (doubling) the step
 
   Dprintf((" Euler integration step ")); // print debugging info
-  Dprintf((" Time = %g, optimal step = %g", (double)Time, OptStep));
+  Dprintf((" Time = %g, optimal step = %g", (double)SIMLIB_Time, SIMLIB_OptStep));
 
   end_it=LastIntegrator(); // end of container of integrators
 
@@ -76,8 +76,8 @@ begin_step: // beginning of step
 
   ////////////////////////////////////////////////////////////// 1/2 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime+dthlf);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime+dthlf);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // compute new state of model                  (1)
 
@@ -99,7 +99,7 @@ begin_step: // beginning of step
 
   //////////////////////////////////////////////////////////// end of step
 
-  _SetTime(Time, SIMLIB_StepStartTime + SIMLIB_StepSize);
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + SIMLIB_StepSize);
   SIMLIB_DeltaTime = SIMLIB_StepSize;
 
   SIMLIB_Dynamic();  // compute new state of model                  (2)
@@ -137,7 +137,7 @@ begin_step: // beginning of step
         break;
     }
 
-    DoubleStepFlag = false;  // disable increasing SIMLIB_OptStep,
+    DoubleStepFlag = false;  // disable increasing OptStep,
                              // accuracy is sufficient, but not well
   } // for
 
@@ -157,7 +157,7 @@ begin_step: // beginning of step
     GoToState(di, si, xi);
 
     SIMLIB_StepStartTime += dthlf;
-    SIMLIB_DeltaTime = double(Time) - SIMLIB_StepStartTime;
+    SIMLIB_DeltaTime = double(SIMLIB_Time) - SIMLIB_StepStartTime;
 
     //-----------------------------------------------------------------------
     //  Analyse system at the end of the step
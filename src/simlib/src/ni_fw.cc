@@ -59,7 +59,7 @@ void FW::Integrate(void)
   static double PrevStep;     // previous FW step
 
   Dprintf((" Fowler-Warten integration step ")); // print debugging info
-  Dprintf((" Time = %g, optimal step = %g", (double)Time, OptStep));
+  Dprintf((" Time = %g, optimal step = %g", (double)SIMLIB_Time, SIMLIB_OptStep));
 
   end_it=LastIntegrator(); // end of container of integrators
 
@@ -100,7 +100,7 @@ euler_step: // beginning of Euler's step
     (*ip)->SetState((*ip)->GetOldState()+Eul_StepSize*(*ip)->GetOldDiff());
   }
 
-  _SetTime(Time,SIMLIB_StepStartTime + Eul_StepSize); // set time to t+he
+  _SetTime(SIMLIB_Time,SIMLIB_StepStartTime + Eul_StepSize); // set time to t+he
   SIMLIB_DeltaTime = Eul_StepSize;
   SIMLIB_Dynamic();  // y'(t+he)=f(t+he, y(t+he))
 
@@ -197,7 +197,7 @@ euler_step: // beginning of Euler's step
     ERR[i] = yia + c0 * d1;
   }
 
-  _SetTime(Time,SIMLIB_StepStartTime + SIMLIB_StepSize); // set time to t+h
+  _SetTime(SIMLIB_Time,SIMLIB_StepStartTime + SIMLIB_StepSize); // set time to t+h
   SIMLIB_DeltaTime = SIMLIB_StepSize;
   SIMLIB_Dynamic(); // compute new state of model
 
@@ -61,7 +61,7 @@ void RKE::Integrate(void)
   Iterator ip, end_it; // of integrators
 
   Dprintf((" RKE integration step ")); // print debugging info
-  Dprintf((" Time = %g, optimal step = %g", (double)Time, OptStep));
+  Dprintf((" Time = %g, optimal step = %g", (double)SIMLIB_Time, SIMLIB_OptStep));
 
   end_it=LastIntegrator(); // end of container of integrators
 
@@ -87,8 +87,8 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 1/4 of step
 
-  _SetTime(Time,SIMLIB_StepStartTime + dtqrt); // time (t) for next sub-step
-  SIMLIB_DeltaTime = double(Time) - SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time,SIMLIB_StepStartTime + dtqrt); // time (t) for next sub-step
+  SIMLIB_DeltaTime = double(SIMLIB_Time) - SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model (y'=f(t,y))      (1)
 
@@ -108,8 +108,8 @@ begin_step:
   //                       1/2 of step
   //////////////////////////////////////////////////////////////
 
-  _SetTime(Time, SIMLIB_StepStartTime+dthlf);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime+dthlf);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (3)
 
@@ -137,8 +137,8 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 3/4 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime+dthlf+dtqrt);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime+dthlf+dtqrt);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (5)
 
@@ -164,7 +164,7 @@ begin_step:
 
   //////////////////////////////////////////////////////////// end of step
 
-  _SetTime(Time, SIMLIB_StepStartTime + SIMLIB_StepSize);
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + SIMLIB_StepSize);
   SIMLIB_DeltaTime = SIMLIB_StepSize;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (7)
@@ -207,7 +207,7 @@ begin_step:
       if(SIMLIB_ConditionFlag) // event was in half step, step reducing was
         break;                 // unpossible and accuracy cannot be achieved
     }
-    DoubleStepFlag = false;    // disable increasing SIMLIB_OptStep,
+    DoubleStepFlag = false;    // disable increasing OptStep,
   }                            // accuracy is sufficient, but not well
   if(SIMLIB_ERRNO) {
     SIMLIB_warning(AccuracyError);
@@ -229,7 +229,7 @@ begin_step:
     }
 
     SIMLIB_StepStartTime += dthlf;
-    SIMLIB_DeltaTime = double(Time) - SIMLIB_StepStartTime;
+    SIMLIB_DeltaTime = double(SIMLIB_Time) - SIMLIB_StepStartTime;
 
     SIMLIB_Dynamic();  // evaluate new state of model                (8)
 
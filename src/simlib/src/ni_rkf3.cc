@@ -56,7 +56,7 @@ void RKF3::Integrate(void)
   size_t n;         // integrator with greatest error
 
   Dprintf((" RKF3 integration step ")); // print debugging info
-  Dprintf((" Time = %g, optimal step = %g", (double)Time, OptStep));
+  Dprintf((" Time = %g, optimal step = %g", (double)SIMLIB_Time, SIMLIB_OptStep));
 
   end_it=LastIntegrator(); // end of container of integrators
 
@@ -80,8 +80,8 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 1/2 of step
 
-  _SetTime(Time,SIMLIB_StepStartTime + 0.5*SIMLIB_StepSize); // substep's time
-  SIMLIB_DeltaTime = double(Time) - SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time,SIMLIB_StepStartTime + 0.5*SIMLIB_StepSize); // substep's time
+  SIMLIB_DeltaTime = double(SIMLIB_Time) - SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model (y'=f(t,y))      (1)
 
@@ -92,8 +92,8 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 3/4 of step
 
-  _SetTime(Time,SIMLIB_StepStartTime + 0.75*SIMLIB_StepSize); //substep's time
-  SIMLIB_DeltaTime = double(Time) - SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time,SIMLIB_StepStartTime + 0.75*SIMLIB_StepSize); //substep's time
+  SIMLIB_DeltaTime = double(SIMLIB_Time) - SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (2)
 
@@ -105,7 +105,7 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 1.0 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime+SIMLIB_StepSize); // goto end time point
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime+SIMLIB_StepSize); // goto end time point
   SIMLIB_DeltaTime = SIMLIB_StepSize;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (3)
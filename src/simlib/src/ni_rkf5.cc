@@ -69,7 +69,7 @@ void RKF5::Integrate(void)
   size_t n;       // integrator with the greatest error
 
   Dprintf((" RKF5 integration step ")); // print debugging info
-  Dprintf((" Time = %g, optimal step = %g", (double)Time, OptStep));
+  Dprintf((" Time = %g, optimal step = %g", (double)SIMLIB_Time, SIMLIB_OptStep));
 
   end_it=LastIntegrator(); // end of container of integrators
 
@@ -93,8 +93,8 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 0.2 of step
 
-  _SetTime(Time,SIMLIB_StepStartTime + 0.2*SIMLIB_StepSize); // substep's time
-  SIMLIB_DeltaTime = double(Time) - SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time,SIMLIB_StepStartTime + 0.2*SIMLIB_StepSize); // substep's time
+  SIMLIB_DeltaTime = double(SIMLIB_Time) - SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model (y'=f(t,y))      (1)
 
@@ -105,8 +105,8 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 0.3 of step
 
-  _SetTime(Time,SIMLIB_StepStartTime + 0.3*SIMLIB_StepSize); //substep's time
-  SIMLIB_DeltaTime = double(Time) - SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time,SIMLIB_StepStartTime + 0.3*SIMLIB_StepSize); //substep's time
+  SIMLIB_DeltaTime = double(SIMLIB_Time) - SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (2)
 
@@ -117,8 +117,8 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 0.6 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime+0.6*SIMLIB_StepSize);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime+0.6*SIMLIB_StepSize);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (3)
 
@@ -132,8 +132,8 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 1.0 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime+SIMLIB_StepSize);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime+SIMLIB_StepSize);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (4)
 
@@ -148,8 +148,8 @@ begin_step:
 
   ///////////////////////////////////////////////////////////// 0.875 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime+0.875*SIMLIB_StepSize);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime+0.875*SIMLIB_StepSize);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (5)
 
@@ -163,7 +163,7 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// end of step
 
-  _SetTime(Time, SIMLIB_StepStartTime+SIMLIB_StepSize); // go to end of step
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime+SIMLIB_StepSize); // go to end of step
   SIMLIB_DeltaTime = SIMLIB_StepSize;
   SIMLIB_Dynamic();
 
@@ -51,7 +51,7 @@ void RKF8::Integrate(void)
   size_t n;         // integrator with greatest error
 
   Dprintf((" RKF8 integration step ")); // print debugging info
-  Dprintf((" Time = %g, optimal step = %g", (double)Time, OptStep));
+  Dprintf((" Time = %g, optimal step = %g", (double)SIMLIB_Time, SIMLIB_OptStep));
 
   end_it=LastIntegrator(); // end of container of integrators
 
@@ -75,8 +75,8 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 1/4 of step
 
-  _SetTime(Time,SIMLIB_StepStartTime + 0.25*SIMLIB_StepSize); // substep time
-  SIMLIB_DeltaTime = double(Time) - SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time,SIMLIB_StepStartTime + 0.25*SIMLIB_StepSize); // substep time
+  SIMLIB_DeltaTime = double(SIMLIB_Time) - SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model (y'=f(t,y))      (1)
 
@@ -87,8 +87,8 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 1/12 of step
 
-  _SetTime(Time,SIMLIB_StepStartTime + 1.0/12.0*SIMLIB_StepSize); // substep
-  SIMLIB_DeltaTime = double(Time) - SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time,SIMLIB_StepStartTime + 1.0/12.0*SIMLIB_StepSize); // substep
+  SIMLIB_DeltaTime = double(SIMLIB_Time) - SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (2)
 
@@ -99,8 +99,8 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 1/8 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime + 0.125*SIMLIB_StepSize);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + 0.125*SIMLIB_StepSize);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (3)
 
@@ -114,8 +114,8 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 2/5 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime + 0.4*SIMLIB_StepSize);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + 0.4*SIMLIB_StepSize);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (4)
 
@@ -128,8 +128,8 @@ begin_step:
 
   ///////////////////////////////////////////////////////////// 1/2 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime + 0.5*SIMLIB_StepSize);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + 0.5*SIMLIB_StepSize);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (5)
 
@@ -143,8 +143,8 @@ begin_step:
 
   ///////////////////////////////////////////////////////////// 6/7 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime + 6.0/7.0*SIMLIB_StepSize);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + 6.0/7.0*SIMLIB_StepSize);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (6)
 
@@ -158,8 +158,8 @@ begin_step:
 
   ///////////////////////////////////////////////////////////// 1/7 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime + 1.0/7.0*SIMLIB_StepSize);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + 1.0/7.0*SIMLIB_StepSize);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (7)
 
@@ -175,8 +175,8 @@ begin_step:
 
   ///////////////////////////////////////////////////////////// 2/3 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime + 2.0/3.0*SIMLIB_StepSize);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + 2.0/3.0*SIMLIB_StepSize);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (8)
 
@@ -193,8 +193,8 @@ begin_step:
 
   ///////////////////////////////////////////////////////////// 2/7 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime + 2.0/7.0*SIMLIB_StepSize);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + 2.0/7.0*SIMLIB_StepSize);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (9)
 
@@ -212,8 +212,8 @@ begin_step:
 
   ///////////////////////////////////////////////////////////// 1/1 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime + SIMLIB_StepSize);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + SIMLIB_StepSize);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (10)
 
@@ -231,8 +231,8 @@ begin_step:
 
   ///////////////////////////////////////////////////////////// 1/3 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime + 1.0/3.0*SIMLIB_StepSize);
-  SIMLIB_DeltaTime = double(Time)-SIMLIB_StepStartTime;
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + 1.0/3.0*SIMLIB_StepSize);
+  SIMLIB_DeltaTime = double(SIMLIB_Time)-SIMLIB_StepStartTime;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (11)
 
@@ -251,7 +251,7 @@ begin_step:
 
   ////////////////////////////////////////////////////////////// 1/1 of step
 
-  _SetTime(Time, SIMLIB_StepStartTime+SIMLIB_StepSize);
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime+SIMLIB_StepSize);
   SIMLIB_DeltaTime = SIMLIB_StepSize;
 
   SIMLIB_Dynamic();  // evaluate new state of model                  (9)
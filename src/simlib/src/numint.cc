@@ -51,9 +51,9 @@ SIMLIB_IMPLEMENTATION;
 ///  step of numerical integration method
 void IntegrationMethod::StepSim(void)
 {
-  Dprintf(("==================== continuous step BEGIN %.15g",Time));
+  Dprintf(("==================== continuous step BEGIN %.15g",SIMLIB_Time));
 #ifndef NDEBUG
-  double Step_StartTime = Time;
+  double Step_StartTime = SIMLIB_Time;
 #endif
   SIMLIB_DynamicFlag = true; // numerical integration is running
   if(Prepare()) { // initialize integration step (condition is not changed)
@@ -65,8 +65,8 @@ void IntegrationMethod::StepSim(void)
     Summarize(); // set up new state in the system
   }
   SIMLIB_DynamicFlag = false; // end of numerical integration
-  Dprintf((" Step length = %g ", Time - Step_StartTime ));
-  Dprintf(("==================== continuous step END %.15g",Time));
+  Dprintf((" Step length = %g ", SIMLIB_Time - Step_StartTime ));
+  Dprintf(("==================== continuous step END %.15g",SIMLIB_Time));
 }
 
 
@@ -92,7 +92,7 @@ void IntegrationMethod::Iterate(void)
     SIMLIB_StepSize = max(SIMLIB_MinStep, SIMLIB_StepSize);
     SIMLIB_ContractStepFlag = false;           // don't reduce step
     SIMLIB_ContractStep = 0.5*SIMLIB_StepSize; // implicitly reduce to half
-    _SetTime(Time, SIMLIB_StepStartTime + SIMLIB_StepSize);
+    _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + SIMLIB_StepSize);
     SIMLIB_DeltaTime = SIMLIB_StepSize;
 
     SIMLIB_Dynamic(); // evaluate new state of model - only state blocks
@@ -114,12 +114,12 @@ void IntegrationMethod::Iterate(void)
 void IntegrationMethod::Summarize(void)
 {
   Dprintf(("IntegrationMethod::Summarize()"));
-  SIMLIB_StepStartTime = Time;
+  SIMLIB_StepStartTime = SIMLIB_Time;
   SIMLIB_DeltaTime = 0.0;
   IntegratorContainer::NtoL();
   StatusContainer::NtoL();
   if(IsEndStepEvent)          // event at the end of step
-    _SetTime(Time, NextTime); // suppress inaccuracy of float
+    _SetTime(SIMLIB_Time, SIMLIB_NextTime); // suppress inaccuracy of float
 } // IntegrationMethod::Summarize
 
 
@@ -133,13 +133,13 @@ bool IntegrationMethod::Prepare(void)
 
  // If an event is scheduled within the step,
   // set on flag, that will be event at the end of the step
-  IsEndStepEvent=(bool)(double(Time)+1.01*SIMLIB_StepSize>=NextTime);//1.1???
+  IsEndStepEvent=(bool)(double(SIMLIB_Time)+1.01*SIMLIB_StepSize>=SIMLIB_NextTime);//1.1???
   // and adjust step size, so that event will take place at end of step
   if(IsEndStepEvent)
-    SIMLIB_StepSize = double(NextTime)-double(Time);
+    SIMLIB_StepSize = double(SIMLIB_NextTime)-double(SIMLIB_Time);
 
   // set up auxiliary variables
-  SIMLIB_StepStartTime = Time; // start time of integration
+  SIMLIB_StepStartTime = SIMLIB_Time; // start time of integration
   SIMLIB_DeltaTime = 0.0;      // time since beginning of integration
 
   if(SIMLIB_ResetStatus) { // initialization of integration is requested
@@ -338,12 +338,12 @@ void IntegrationMethod::FunCall(double step_frag)
 {
   if(step_frag==1.0) {  // accuracy!
     // substep time
-    _SetTime(Time, SIMLIB_StepStartTime + SIMLIB_StepSize);
+    _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + SIMLIB_StepSize);
     SIMLIB_DeltaTime = SIMLIB_StepSize;
   } else {
     // substep time
-    _SetTime(Time, SIMLIB_StepStartTime + step_frag*SIMLIB_StepSize);
-    SIMLIB_DeltaTime = double(Time) - SIMLIB_StepStartTime;
+    _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + step_frag*SIMLIB_StepSize);
+    SIMLIB_DeltaTime = double(SIMLIB_Time) - SIMLIB_StepStartTime;
   }
   SIMLIB_Dynamic(); // evaluate new state of model
 }
@@ -612,7 +612,7 @@ void StatusMethod::RestoreState(double dthlf, Memory& di, Memory& si,
     (*sp)->SetState(xi[i]);
   }
 
-  _SetTime(Time, SIMLIB_StepStartTime + dthlf); // half step
+  _SetTime(SIMLIB_Time, SIMLIB_StepStartTime + dthlf); // half step
   IsEndStepEvent = false; // no event will be scheduled at end of step
 } // RestoreState
 
@@ -13,6 +13,7 @@
 #include "simlib.h"
 #include "internal.h"
 #include <unordered_map>          // used by name dictionary
+#include <mutex>
 
 ////////////////////////////////////////////////////////////////////////////
 namespace simlib3 {
@@ -21,14 +22,107 @@ SIMLIB_IMPLEMENTATION;
 ////////////////////////////////////////////////////////////////////////////
 
 // static flag for IsAllocated()
-static bool SimObject_allocated = false;
+static thread_local bool SimObject_allocated = false;
+
+////////////////////////////////////////////////////////////////////////////
+// SimObject memory pool
+// Small objects (entities are created/destroyed very often) are allocated
+// from per-thread pool: size classes of POOL_GRANULE bytes, each with its own
+// freelist and list of chunks. Classes without live objects return their
+// chunks at Init() and at the end of Run() (SIMLIB_ObjectPoolTrim).
+// The pool has no destructor - objects can be deleted at program exit.
+
+static const size_t POOL_GRANULE = 16;          // size class step (alignment)
+static const size_t POOL_MAX_SIZE = 512;        // larger objects: global new
+static const unsigned POOL_CLASSES = POOL_MAX_SIZE / POOL_GRANULE;
+static const size_t POOL_CHUNK_SIZE = 64 * 1024;
+static const size_t POOL_CHUNK_HEADER = 16;     // next chunk pointer, aligned
+
+struct PoolBlock { PoolBlock *next; };          // free block
+
+struct ObjectPool {
+    PoolBlock *free[POOL_CLASSES];      // freelists
+    char *chunks[POOL_CLASSES];         // single-linked chunk lists
+    char *ptr[POOL_CLASSES];            // unused part of the first chunk
+    char *end[POOL_CLASSES];
+    unsigned long live[POOL_CLASSES+1]; // live objects ([POOL_CLASSES]: large)
+    unsigned long allocs[POOL_CLASSES+1]; // number of allocations
+    unsigned long nchunks[POOL_CLASSES];
+};
+static thread_local ObjectPool pool;    // zero-initialized
+
+/// size class index for object size (size>0)
+static inline unsigned PoolClass(size_t size) {
+    return (size - 1) / POOL_GRANULE;
+}
+
+/// allocate block of size class c
+static void *PoolAlloc(unsigned c) {
+    ObjectPool &p = pool;
+    if (PoolBlock *b = p.free[c]) {
+        p.free[c] = b->next;
+        return b;
+    }
+    const size_t bytes = (c + 1) * POOL_GRANULE;
+    if (p.ptr[c] + bytes > p.end[c]) {  // also for ptr==end==0
+        char *chunk = ::new char[POOL_CHUNK_SIZE];
+        *reinterpret_cast<char**>(chunk) = p.chunks[c];
+        p.chunks[c] = chunk;
+        p.ptr[c] = chunk + POOL_CHUNK_HEADER;
+        p.end[c] = chunk + POOL_CHUNK_SIZE;
+        p.nchunks[c]++;
+    }
+    void *b = p.ptr[c];
+    p.ptr[c] += bytes;
+    return b;
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// return memory of size classes without live objects
+/// (called at Init() and at the end of Run())
+void SIMLIB_ObjectPoolTrim() {
+    ObjectPool &p = pool;
+    for (unsigned c = 0; c < POOL_CLASSES; c++) {
+        if (p.live[c] != 0 || p.chunks[c] == 0)
+            continue;
+        char *chunk = p.chunks[c];
+        while (chunk) {
+            char *next = *reinterpret_cast<char**>(chunk);
+            ::delete[] chunk;
+            chunk = next;
+        }
+        p.free[c] = 0;
+        p.chunks[c] = p.ptr[c] = p.end[c] = 0;
+        p.nchunks[c] = 0;
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////
+/// statistics of SimObject memory pool for size class c
+/// <br> last class (c==SimObjectPoolClasses()-1) contains large objects
+bool SimObjectPoolStatistics(unsigned c, SimObjectPoolStat &st) {
+    if (c > POOL_CLASSES)
+        return false;
+    const ObjectPool &p = pool;
+    st.size = c < POOL_CLASSES ? (c + 1) * POOL_GRANULE : 0;
+    st.live = p.live[c];
+    st.allocs = p.allocs[c];
+    st.chunks = c < POOL_CLASSES ? p.nchunks[c] : 0;
+    return true;
+}
+
+unsigned SimObjectPoolClasses() {
+    return POOL_CLASSES + 1;
+}
 
 // NameDict singleton: dictionary for partial SimObject->name mapping
 // Naming is not performance sensitive part of SIMLIB/C++
 // We use this approach to save memory (64bit: sizeof(std::string)==32)
+// The dictionary is shared by all threads (simulation contexts).
 class NameDict {
     using TNameDict = std::unordered_map<SimObject*,std::string>;
     static TNameDict *dict;
+    static std::mutex mutex;
   public:
     NameDict() {
         if(dict==nullptr) {     // can be created before construction
@@ -39,12 +133,14 @@ class NameDict {
     // can be used before singleton construction
     // Warning: do not use in destructors!
     void Set(SimObject *o, const std::string &name) {
+        std::lock_guard<std::mutex> lock(mutex);
         if(dict==nullptr) {
             dict = new TNameDict;
         }
         (*dict)[o] = name;
     }
     std::string Get(const SimObject *o) const {
+        std::lock_guard<std::mutex> lock(mutex);
         if(dict==nullptr)
             return ""; // name dictionary not created -> empty name
         TNameDict::iterator it = dict->find(const_cast<SimObject*>(o));
@@ -53,28 +149,34 @@ class NameDict {
         return it->second;
     }
     void Erase(SimObject *o) {
+        std::lock_guard<std::mutex> lock(mutex);
         if(dict!=nullptr)
             dict->erase(o);
     }
     ~NameDict() {       // remove dictionary, all named objects -> ""
+        std::lock_guard<std::mutex> lock(mutex);
         delete dict;
         dict=nullptr;   // important for Get called after dict destruction
     }
 };
 
 NameDict::TNameDict *NameDict::dict = nullptr; // static member initialization
+std::mutex NameDict::mutex;                     // constexpr constructor
 static NameDict name_dict; // SINGLETON, possible problems (empty names) if used after destruction
 
 ////////////////////////////////////////////////////////////////////////////
 //! allocate memory for object
-// TODO: optimize for small objects?
+//! small objects are allocated from size-class pool
 void *SimObject::operator new(size_t size) {
   void *ptr;
-//  try {
+  const unsigned c = size ? PoolClass(size) : 0;
+  if (c < POOL_CLASSES)
+    ptr = PoolAlloc(c);
+  else
     ptr = ::new char[size]; // global operator new
 //  Dprintf(("SimObject::operator new(%u) = %p ", size, ptr));  // ### add extra debug level for this
-//  }catch(...) { SIMLIB_error(MemoryError); }
-//  if(!ptr) SIMLIB_error(MemoryError); // only for VERY old compilers
+  pool.live[c < POOL_CLASSES ? c : POOL_CLASSES]++;
+  pool.allocs[c < POOL_CLASSES ? c : POOL_CLASSES]++;
   SimObject_allocated = true; // update flag (checked in constructor)
   return ptr;
 }
@@ -84,12 +186,21 @@ void *SimObject::operator new(size_t size) {
 //
 //TODO: this can create trouble if called from e.g. Behavior()
 //
-void SimObject::operator delete(void *ptr) {
+void SimObject::operator delete(void *ptr, size_t size) {
 //  Dprintf(("SimObject::operator delete(%p) ", ptr));
   SimObject *sp = static_cast<SimObject*>(ptr);
   if (sp->isAllocated()) {
       sp->_flags = 0; // clear all flags
-      ::operator delete[](ptr);  // free memory
+      const unsigned c = size ? PoolClass(size) : 0;
+      if (c < POOL_CLASSES) {
+          PoolBlock *b = static_cast<PoolBlock*>(ptr);
+          b->next = pool.free[c];     // return to freelist
+          pool.free[c] = b;
+          pool.live[c]--;
+      } else {
+          ::operator delete[](ptr);  // free memory
+          pool.live[POOL_CLASSES]--;
+      }
   }
 }
 
@@ -117,6 +228,8 @@ SimObject::~SimObject()
     if(HasName()) {
         name_dict.Erase(this);
     }
+    if(_flags & _REPORT_FLAG)
+        SIMLIB_OutputUnregister(this);
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -64,13 +64,27 @@ void SIMLIB_statistics_t::Output() const
 {
     Print("#\n");
     Print("# SIMLIB run-time statistics:\n");
-    Print("#    StartTime  = %g\n", StartTime);
-    Print("#    EndTime    = %g\n", EndTime);
+    Print("#    StartTime  = %g\n", SIMLIB_StartTime);
+    Print("#    EndTime    = %g\n", SIMLIB_EndTime);
     Print("#    EventCount = %ld\n", EventCount);
     Print("#    StepCount  = %ld\n", StepCount);
     if (StepCount>0) {
-        Print("#    MinStep    = %g\n", MinStep);
-        Print("#    MaxStep    = %g\n", MaxStep);
+        Print("#    MinStep    = %g\n", SIMLIB_MinStep);
+        Print("#    MaxStep    = %g\n", SIMLIB_MaxStep);
+    }
+    Print("#    EventNotice allocations = %ld\n", EventNoticeAllocs);
+    Print("#    EventNotice live/max    = %ld/%ld\n", EventNoticeLive, EventNoticeMaxLive);
+    Print("#    EventNotice chunks      = %ld (%ld freed)\n", EventNoticeChunks, EventNoticeChunksFreed);
+    SimObjectPoolStat st;
+    for (unsigned c = 0; SimObjectPoolStatistics(c, st); c++) {
+        if (st.allocs == 0)
+            continue;
+        if (st.size)
+            Print("#    SimObject pool %4lu B  = %lu live, %lu allocations, %lu chunks\n",
+                  (unsigned long)st.size, st.live, st.allocs, st.chunks);
+        else
+            Print("#    SimObject large       = %lu live, %lu allocations\n",
+                  st.live, st.allocs);
     }
     Print("#\n");
 }
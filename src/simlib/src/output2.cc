@@ -19,6 +19,7 @@
 #include "internal.h"
 
 #include <cstdio>    // sprintf()
+#include <vector>
 
 
 ////////////////////////////////////////////////////////////////////////////
@@ -42,10 +43,10 @@ void Facility::Output() const
   Print("| %-56s |\n",s);
   if (tstat.Number()>0)
   {
-    sprintf(s," Time interval = %g - %g ",tstat.StartTime(), (double)Time);
+    sprintf(s," Time interval = %g - %g ",tstat.StartTime(), (double)SIMLIB_Time);
     Print(  "| %-56s |\n", s);
     Print(  "|  Number of requests = %-28ld       |\n", tstat.Number());
-    if (Time>tstat.StartTime())
+    if (SIMLIB_Time>tstat.StartTime())
       Print("|  Average utilization = %-27g       |\n", tstat.MeanValue());
   }
   Print("+----------------------------------------------------------+\n");
@@ -121,13 +122,13 @@ void Queue::Output() const
   {
     Print("+----------------------------------------------------------+\n");
     char s[100];        // FIXME: "100 bytes should be enough"
-    sprintf(s," Time interval = %g - %g ",StatN.StartTime(), (double)Time);
+    sprintf(s," Time interval = %g - %g ",StatN.StartTime(), (double)SIMLIB_Time);
     Print(  "| %-56s |\n", s);
     Print(  "|  Incoming  %-26ld                    |\n", StatN.Number());
     Print(  "|  Outcoming  %-26ld                   |\n", StatDT.Number());
     Print(  "|  Current length = %-26lu             |\n", size());
     Print(  "|  Maximal length = %-25g              |\n", StatN.Max());
-    double dt = double(Time) - StatN.StartTime();
+    double dt = double(SIMLIB_Time) - StatN.StartTime();
     if(dt>0)
     {
       double mv = StatN.MeanValue();
@@ -160,6 +161,34 @@ void Queue::Output() const
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////
+//  QuantileHistogram::Output
+//
+void QuantileHistogram::Output() const
+{
+  static const double p[] = { 0.5, 0.9, 0.95, 0.99, 0.999 };
+  Print("+----------------------------------------------------------+\n");
+  Print("| QUANTILES %-46s |\n",Name().c_str());
+  Print("+----------------------------------------------------------+\n");
+  if (n==0) {
+    Print("|  no record                                               |\n");
+    Print("+----------------------------------------------------------+\n");
+    return;
+  }
+  Print(  "|  Min = %-15g         Max = %-15g     |\n", min, max);
+  Print(  "|  Number of records = %-26ld          |\n", n);
+  Print(  "|  Average value = %-25g               |\n", MeanValue());
+  Print(  "|  Relative error = %-24g               |\n", RelativeError());
+  if (dptr[0])
+    Print("|  Values below low = %-25lu            |\n", dptr[0]);
+  if (dptr[Buckets()+1])
+    Print("|  Values above high = %-25lu           |\n", dptr[Buckets()+1]);
+  Print("+----------------------------------------------------------+\n");
+  for (unsigned i=0; i<sizeof(p)/sizeof(p[0]); i++)
+    Print("|  p%-6g = %-45g |\n", 100*p[i], Quantile(p[i]));
+  Print("+----------------------------------------------------------+\n");
+}
+
 ////////////////////////////////////////////////////////////////////////////
 //  Stat::Output
 //
@@ -195,12 +224,12 @@ void Store::Output() const
   Print("| %-56s |\n",s);
   if (tstat.n>0)
   {
-    sprintf(s," Time interval = %g - %g ",tstat.StartTime(), (double)Time);
+    sprintf(s," Time interval = %g - %g ",tstat.StartTime(), (double)SIMLIB_Time);
     Print(  "| %-56s |\n", s);
     Print(  "|  Number of Enter operations = %-24ld   |\n", tstat.Number());
     Print(  "|  Minimal used capacity = %-30g  |\n", tstat.Min());
     Print(  "|  Maximal used capacity = %-30g  |\n", tstat.Max());
-    if (Time>tstat.StartTime())
+    if (SIMLIB_Time>tstat.StartTime())
       Print("|  Average used capacity = %-30g  |\n", tstat.MeanValue());
   }
   Print("+----------------------------------------------------------+\n");
@@ -231,15 +260,125 @@ void TStat::Output() const
   {
     char s[100];
     Print(  "|  Min = %-15g         Max = %-15g     |\n", min, max);
-    sprintf(s," Time = %g - %g ", t0, (double)Time);
+    sprintf(s," Time = %g - %g ", t0, (double)SIMLIB_Time);
     Print(  "| %-56s |\n", s);
     Print(  "|  Number of records = %-26ld          |\n", n);
-    if (Time>t0)
+    if (SIMLIB_Time>t0)
       Print("|  Average value = %-25g               |\n", MeanValue());
   }
   Print("+----------------------------------------------------------+\n");
 }
 
+////////////////////////////////////////////////////////////////////////////
+//  Report methods --- structured output (see report.cc)
+//
+
+void Stat::Report(OutputFormatter &f, const char *key) const
+{
+  f.BeginObject(key, "stat", Name());
+  f.Field("n", n);
+  if (n>0)
+  {
+    f.Field("min", min);
+    f.Field("max", max);
+    f.Field("mean", mean);
+    if (n>1)
+      f.Field("stddev", StdDev());
+  }
+  f.EndObject();
+}
+
+void TStat::Report(OutputFormatter &f, const char *key) const
+{
+  f.BeginObject(key, "tstat", Name());
+  f.Field("n", n);
+  f.Field("start_time", t0);
+  if (n>0)
+  {
+    f.Field("min", min);
+    f.Field("max", max);
+    f.Field("last_value", xl);
+    if (SIMLIB_Time>t0)
+    {
+      f.Field("mean", MeanValue());
+      f.Field("stddev", StdDev());
+    }
+  }
+  f.EndObject();
+}
+
+void Queue::Report(OutputFormatter &f, const char *key) const
+{
+  f.BeginObject(key, "queue", Name());
+  f.Field("length", (unsigned long)size());
+  StatN.Report(f, "length_stat");
+  StatDT.Report(f, "time_stat");
+  f.EndObject();
+}
+
+void Histogram::Report(OutputFormatter &f, const char *key) const
+{
+  f.BeginObject(key, "histogram", Name());
+  f.Field("low", low);
+  f.Field("step", step);
+  f.Field("count", (unsigned long)count);
+  stat.Report(f, "stat");
+  std::vector<unsigned long> counts(dptr, dptr+count+2);  // with under/overflow
+  f.Array("counts", counts.data(), count+2);
+  f.EndObject();
+}
+
+void QuantileHistogram::Report(OutputFormatter &f, const char *key) const
+{
+  static const double p[] = { 0.5, 0.9, 0.95, 0.99, 0.999 };
+  f.BeginObject(key, "quantiles", Name());
+  f.Field("n", n);
+  f.Field("low", low);
+  f.Field("high", High());
+  f.Field("bits", (unsigned long)bits);
+  f.Field("relative_error", RelativeError());
+  if (n>0)
+  {
+    f.Field("min", min);
+    f.Field("max", max);
+    f.Field("mean", MeanValue());
+    for (unsigned i=0; i<sizeof(p)/sizeof(p[0]); i++)
+    {
+      char k[16];
+      sprintf(k, "p%g", 100*p[i]);
+      f.Field(k, Quantile(p[i]));
+    }
+  }
+  f.Array("counts", dptr, Buckets()+2);       // with below low/above high
+  f.EndObject();
+}
+
+void Facility::Report(OutputFormatter &f, const char *key) const
+{
+  f.BeginObject(key, "facility", Name());
+  f.Field("busy", (unsigned long)Busy());
+  tstat.Report(f, "utilization");
+  if (OwnQueue())
+    Q1->Report(f, "queue");
+  else
+    f.Field("queue", Q1->Name());
+  Q2->Report(f, "interrupted");
+  f.EndObject();
+}
+
+void Store::Report(OutputFormatter &f, const char *key) const
+{
+  f.BeginObject(key, "store", Name());
+  f.Field("capacity", capacity);
+  f.Field("used", used);
+  tstat.Report(f, "usage");
+  if (OwnQueue())
+    Q->Report(f, "queue");
+  else
+    f.Field("queue", Q->Name());
+  f.EndObject();
+}
+
 }
 // end of output2.cc
 
@@ -62,6 +62,15 @@ void SetOutput(const char *name)
   }
 }
 
+////////////////////////////////////////////////////////////////////////////
+//  SIMLIB_OutputWrite --- write formatted report (binary data, too)
+//
+bool SIMLIB_OutputWrite(const std::string &data)
+{
+  bool ok = fwrite(data.data(), 1, data.size(), OutFile) == data.size();
+  return fflush(OutFile) == 0 && ok;
+}
+
 ////////////////////////////////////////////////////////////////////////////
 //  _Print
 //
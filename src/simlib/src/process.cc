@@ -13,20 +13,35 @@
 //
 // Implementation of interruptable functions (non-preemptive, coroutine-like)
 //
-// We need code to save/restore process stack contents and working setjmp/longjmp
-// This approach has advantage in smaller memory requirements.
+// There are two implementations selected by compile-time option
+// SIMLIB_PROCESS_STACK_SWITCH:
 //
-// LIMITATIONS:
-//  - do not use (e.g. using pointers) any locals in Process::Behavior() if it
-//    is not in running state (stack contents is moved to heap)
-//  - do not use too big locals in Process::Behavior() for performance reasons
+// 0 == stack copying (default):
+//   We need code to save/restore process stack contents and working
+//   setjmp/longjmp. This approach has advantage in smaller memory requirements.
+//
+//   LIMITATIONS:
+//    - do not use (e.g. using pointers) any locals in Process::Behavior() if it
+//      is not in running state (stack contents is moved to heap)
+//    - do not use too big locals in Process::Behavior() for performance reasons
+//
+// 1 == stack switching:
+//   Each started process runs on its own stack (SIMLIB_PROCESS_STACK_SIZE
+//   bytes, mmap-ed with guard page at the bottom). Stacks of terminated
+//   processes are kept in pool and reused. Switching saves only callee-saved
+//   registers (x86-64 assembly) or uses swapcontext() on other platforms.
+//   Locals of Behavior() stay in place, the only limit is the stack size.
+//   Memory is reserved per live process, but only touched pages are used.
+//   Each stack costs two memory mappings (stack and guard page), so the
+//   number of live processes is limited (vm.max_map_count, about 32k on
+//   Linux). Processes started when no stack can be mapped run with stack
+//   copying. Switching is slower than copying of small stacks with many
+//   live processes (cache and TLB misses), it pays off for big locals.
 //
 // WARNING: dirty hacks inside
 //
 
-// TODO: add implementation with stack switching (not copying)
-//       as compile-time option
-// TODO: add implementation using C++20 coroutines?
+// See coprocess.h for processes implemented by C++20 coroutines.
 
 
 ////////////////////////////////////////////////////////////////////////////
@@ -36,7 +51,35 @@
 #include "simlib.h"
 #include "internal.h"
 
+/// \def SIMLIB_PROCESS_STACK_SWITCH
+/// compile-time selection of process implementation (0==copy, 1==switch)
+#ifndef SIMLIB_PROCESS_STACK_SWITCH
+# define SIMLIB_PROCESS_STACK_SWITCH 0
+#endif
+
+#if SIMLIB_PROCESS_STACK_SWITCH
+/// \def SIMLIB_PROCESS_STACK_SIZE
+/// usable stack size of single process (without guard page)
+# ifndef SIMLIB_PROCESS_STACK_SIZE
+#  define SIMLIB_PROCESS_STACK_SIZE (256*1024UL)
+# endif
+/// \def SIMLIB_PROCESS_ASM_SWITCH
+/// 1==hand-written context switch, 0==portable ucontext switch
+# ifndef SIMLIB_PROCESS_ASM_SWITCH
+#  if defined(__x86_64__) && defined(__ELF__)
+#   define SIMLIB_PROCESS_ASM_SWITCH 1
+#  else
+#   define SIMLIB_PROCESS_ASM_SWITCH 0
+#  endif
+# endif
+# if !SIMLIB_PROCESS_ASM_SWITCH
+#  include <ucontext.h>
+# endif
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
 #include <csetjmp>
+#include <cstdint>
 #include <cstring>
 
 static_assert(sizeof(void*) >= 4, "not tested on <32bit systems");
@@ -49,6 +92,9 @@ namespace simlib3 {
 
 SIMLIB_IMPLEMENTATION;
 
+////////////////////////////////////////////////////////////////////////////
+// Stack copying implementation
+// (with stack switching used only for processes without own stack)
 ////////////////////////////////////////////////////////////////////////////
 
 /**
@@ -62,15 +108,14 @@ struct P_Context_t {
 };
 
 ////////////////////////////////////////////////////////////////////////////
-// global variables (should be volatile)
+// global variables (should be volatile), one set per thread
 // (P_ means Process)
-// TODO: wrap to thread_local struct together with (almost) all globals
-static jmp_buf P_DispatcherStatusBuffer; //!< setjmp() state before dispatch
-static char *volatile P_StackBase = 0;   //!< global start of stack area
-static char *volatile P_StackBase2 = 0;  //!< used for checking only
+static thread_local jmp_buf P_DispatcherStatusBuffer; //!< setjmp() state before dispatch
+static thread_local char *volatile P_StackBase = 0;   //!< global start of stack area
+static thread_local char *volatile P_StackBase2 = 0;  //!< used for checking only
 
-static P_Context_t *volatile P_Context = 0; //!< temporary global process state
-static volatile size_t P_StackSize = 0;     //!< temporary global stack size
+static thread_local P_Context_t *volatile P_Context = 0; //!< temporary global process state
+static thread_local volatile size_t P_StackSize = 0;     //!< temporary global stack size
 
 ////////////////////////////////////////////////////////////////////////////
 // Support for debugging:
@@ -134,20 +179,6 @@ static volatile size_t P_StackSize = 0;     //!< temporary global stack size
 
 [[gnu::noinline]] static void PROCESS_INTERRUPT_f(); // special function
 
-/// interrupt process behavior execution, continue after return
-#define PROCESS_INTERRUPT()                                              \
-{ /* This should be MACRO */                                            \
-  /* if(!isCurrent())  SIMLIB_error("Can't interrupt..."); */           \
-  this->_status = _INTERRUPTED;                                         \
-  PROCESS_INTERRUPT_f();                                                 \
-  this->_status = _RUNNING;                                             \
-  this->_context = 0;                                                   \
-}
-
-/// does not save context
-#define PROCESS_EXIT() \
-    longjmp(P_DispatcherStatusBuffer, 2)  // jump to dispatcher
-
 // FIXME: allocation/freeing memory is expensive, should be optimized
 
 /// \def ALLOC_CONTEXT
@@ -167,6 +198,248 @@ static volatile size_t P_StackSize = 0;     //!< temporary global stack size
     P_Context = 0;
 }
 
+/// Process::_context of process with copied stack
+/// (tagged by the lowest bit if processes can have own stacks, too)
+static inline void *P_CopyTag(P_Context_t *c) noexcept {
+    return reinterpret_cast<char*>(c) + SIMLIB_PROCESS_STACK_SWITCH;
+}
+
+/// saved context from Process::_context of process with copied stack
+static inline P_Context_t *P_CopyContext(void *context) noexcept {
+    return reinterpret_cast<P_Context_t*>(static_cast<char*>(context) - SIMLIB_PROCESS_STACK_SWITCH);
+}
+
+/// Process::_context is context of copied stack (not own stack)
+static inline bool P_IsCopyContext(void *context) noexcept {
+    return !SIMLIB_PROCESS_STACK_SWITCH || (reinterpret_cast<uintptr_t>(context) & 1);
+}
+
+#if SIMLIB_PROCESS_STACK_SWITCH
+////////////////////////////////////////////////////////////////////////////
+// Stack switching implementation
+////////////////////////////////////////////////////////////////////////////
+
+/**
+ * internal structure describing process stack
+ * It is placed at the top of the stack mapping (above the usable stack).
+ * @ingroup process
+ */
+struct P_Stack_t {
+    P_Stack_t *next;    //!< next free stack in pool
+    char *base;         //!< start of mapping (guard page)
+    size_t size;        //!< size of mapping
+#if SIMLIB_PROCESS_ASM_SWITCH
+    void *sp;           //!< saved stack pointer
+#else
+    ucontext_t uc;      //!< saved CPU context
+#endif
+};
+
+////////////////////////////////////////////////////////////////////////////
+// global variables, one set per thread (stacks are not freed at thread exit)
+// (P_ means Process)
+static thread_local P_Stack_t *P_StackPool = 0; //!< free stacks for reuse
+static thread_local P_Stack_t *P_Current = 0;   //!< stack of running process
+static thread_local Process *P_Starting = 0;    //!< process to start on new stack
+static thread_local bool P_Finished = false;    //!< Behavior() returned
+
+#if SIMLIB_PROCESS_ASM_SWITCH
+static thread_local void *P_DispatcherSP = 0;   //!< stack pointer of dispatcher
+
+/// Save callee-saved registers (System V x86-64 ABI) to current stack,
+/// store stack pointer to *save_sp, load new_sp and restore registers
+/// from the other stack. Returns on the other stack.
+extern "C" [[gnu::visibility("hidden")]]
+void simlib_switch_stack(void **save_sp, void *new_sp) noexcept;
+
+asm(R"(
+    .pushsection .text
+    .p2align 4
+    .globl simlib_switch_stack
+    .hidden simlib_switch_stack
+    .type simlib_switch_stack, @function
+simlib_switch_stack:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    subq $8, %rsp
+    stmxcsr (%rsp)
+    fnstcw 4(%rsp)
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    ldmxcsr (%rsp)
+    fldcw 4(%rsp)
+    addq $8, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+    .size simlib_switch_stack, .-simlib_switch_stack
+    .popsection
+)");
+#else
+static thread_local ucontext_t P_DispatcherContext; //!< CPU context of dispatcher
+#endif
+
+[[noreturn]] static void P_ProcessEntry() noexcept;
+
+static thread_local bool P_StackExhausted = false; //!< mapping of new stack failed
+
+/// allocate stack from pool or create new one, 0 if no more stacks can be
+/// mapped (e.g. limit of memory mappings: each stack needs two of them),
+/// the process then runs with stack copying
+static P_Stack_t *P_StackAlloc() noexcept
+{
+    P_Stack_t *s = P_StackPool;
+    if (s) {
+        P_StackPool = s->next;
+        return s;
+    }
+    if (P_StackExhausted)
+        return 0;
+    const size_t page = sysconf(_SC_PAGESIZE);
+    const size_t size = (SIMLIB_PROCESS_STACK_SIZE + page - 1) / page * page + page;
+    int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+#ifdef MAP_STACK
+    flags |= MAP_STACK;
+#endif
+    char *base = static_cast<char*>(mmap(0, size, PROT_READ|PROT_WRITE, flags, -1, 0));
+    if (base != MAP_FAILED && mprotect(base, page, PROT_NONE) != 0) {   // guard page
+        munmap(base, size);
+        base = static_cast<char*>(MAP_FAILED);
+    }
+    if (base == MAP_FAILED) {
+        P_StackExhausted = true;
+        SIMLIB_warning("Process stacks exhausted, using stack copying");
+        return 0;
+    }
+    // stack tops are shifted by multiples of cache line (cache coloring),
+    // otherwise all stacks compete for the same cache sets
+    static thread_local unsigned color = 0;
+    const size_t header = ((sizeof(P_Stack_t) + 63) & ~size_t(63))
+                          + (color++ % (page / 64)) * 64;
+    s = reinterpret_cast<P_Stack_t*>(base + size - header);
+    s->next = 0;
+    s->base = base;
+    s->size = size;
+    return s;
+}
+
+/// return stack to pool
+static void P_StackFree(P_Stack_t *s) noexcept
+{
+    s->next = P_StackPool;
+    P_StackPool = s;
+}
+
+/// prepare new stack to start P_ProcessEntry() at first switch
+static void P_StackPrepare(P_Stack_t *s) noexcept
+{
+#if SIMLIB_PROCESS_ASM_SWITCH
+    // initial frame as left by simlib_switch_stack()
+    void **sp = reinterpret_cast<void**>(reinterpret_cast<uintptr_t>(s) & ~uintptr_t(15));
+    *--sp = 0;                                  // fake return address (alignment)
+    *--sp = reinterpret_cast<void*>(P_ProcessEntry); // "return" to entry
+    for (int i = 0; i < 6; i++)
+        *--sp = 0;                              // rbp, rbx, r12-r15
+    *--sp = reinterpret_cast<void*>(uintptr_t(0x037F) << 32 | 0x1F80); // FPU CW, MXCSR
+    s->sp = sp;
+#else
+    if (getcontext(&s->uc) != 0)
+        SIMLIB_error("Process getcontext failed");
+    const size_t page = sysconf(_SC_PAGESIZE);
+    s->uc.uc_stack.ss_sp = s->base + page;
+    s->uc.uc_stack.ss_size = reinterpret_cast<char*>(s) - (s->base + page);
+    s->uc.uc_link = 0;
+    makecontext(&s->uc, P_ProcessEntry, 0);
+#endif
+}
+
+/// switch from dispatcher to process stack s
+static inline void P_SwitchToProcess(P_Stack_t *s) noexcept
+{
+#if SIMLIB_PROCESS_ASM_SWITCH
+    simlib_switch_stack(&P_DispatcherSP, s->sp);
+#else
+    swapcontext(&P_DispatcherContext, &s->uc);
+#endif
+}
+
+/// switch from running process back to dispatcher
+static inline void P_SwitchToDispatcher() noexcept
+{
+#if SIMLIB_PROCESS_ASM_SWITCH
+    simlib_switch_stack(&P_Current->sp, P_DispatcherSP);
+#else
+    swapcontext(&P_Current->uc, &P_DispatcherContext);
+#endif
+}
+
+/// first function on new process stack
+[[noreturn]] static void P_ProcessEntry() noexcept
+{
+    P_Starting->Behavior();
+    P_Finished = true;
+    P_SwitchToDispatcher();             // stack is freed by dispatcher
+    SIMLIB_internal_error();            // never reached
+}
+
+#endif // SIMLIB_PROCESS_STACK_SWITCH
+
+#if !SIMLIB_PROCESS_STACK_SWITCH
+/// interrupt process behavior execution, continue after return
+#define PROCESS_INTERRUPT()                                              \
+{ /* This should be MACRO */                                            \
+  /* if(!isCurrent())  SIMLIB_error("Can't interrupt..."); */           \
+  this->_status = _INTERRUPTED;                                         \
+  PROCESS_INTERRUPT_f();                                                 \
+  this->_status = _RUNNING;                                             \
+  this->_context = 0;                                                   \
+}
+
+/// does not save context
+#define PROCESS_EXIT() \
+    longjmp(P_DispatcherStatusBuffer, 2)  // jump to dispatcher
+
+#else // SIMLIB_PROCESS_STACK_SWITCH
+/// interrupt process behavior execution, continue after return
+/// (process on own stack or with copied stack, see P_StackAlloc)
+#define PROCESS_INTERRUPT()                                              \
+{                                                                       \
+  this->_status = _INTERRUPTED;                                         \
+  if (P_Current)                                                        \
+    P_SwitchToDispatcher();                                             \
+  else {                                                                \
+    PROCESS_INTERRUPT_f();                                               \
+    this->_context = 0;                                                 \
+  }                                                                     \
+  this->_status = _RUNNING;                                             \
+}
+
+/// does not save context, jump to dispatcher, never continues
+#define PROCESS_EXIT() \
+    (P_Current ? P_SwitchToDispatcher() : longjmp(P_DispatcherStatusBuffer, 2))
+
+#endif // SIMLIB_PROCESS_STACK_SWITCH
+
+/// deallocate context of interrupted (not running) process
+static void DESTROY_CONTEXT(void *context) noexcept {
+    if (context == 0)
+        return;
+    if (P_IsCopyContext(context))
+        delete [] reinterpret_cast<char*>(P_CopyContext(context));
+#if SIMLIB_PROCESS_STACK_SWITCH
+    else
+        P_StackFree(static_cast<P_Stack_t*>(context));
+#endif
+}
+
 ////////////////////////////////////////////////////////////////////////////
 /// Process constructor
 /// sets state to PREPARED
@@ -189,7 +462,7 @@ Process::~Process()
     //if(this==Current) SIMLIB_warning("Currently running process self-destructed");
 
     // destroy context data
-    delete [] static_cast<char*>(_context);
+    DESTROY_CONTEXT(_context);
     _context = 0;
 
     _status = _TERMINATED;
@@ -256,7 +529,7 @@ void Process::Activate(double t)
 void Process::Wait(double dtime)
 {
     Dprintf(("Process#%lu.Wait(%g)", _Ident, dtime));
-    Entity::Activate(double (Time) + dtime);    // (re)scheduling
+    Entity::Activate(double (SIMLIB_Time) + dtime);    // (re)scheduling
     if (!isCurrent())
         return;
     PROCESS_INTERRUPT();
@@ -389,8 +662,8 @@ void Process::Terminate()
 }
 
 /**
- * \fn Process::_Run
- * Process dispatch method
+ * \fn Process::_RunCopy
+ * Process dispatch method of stack copying implementation
  *
  * The dispatcher starts/reactivates process Behavior() method
  *
@@ -409,7 +682,7 @@ void Process::Terminate()
  *
  * @ingroup process
  */
-void Process::_Run() noexcept // no exceptions
+void Process::_RunCopy() noexcept // no exceptions
 {
     // WARNING: all local variables should be volatile (see setjmp manual)
     static const char * status_strings[] = {
@@ -492,7 +765,7 @@ void Process::_Run() noexcept // no exceptions
             // RESTORE_CONTEXT
             // a) Save local variables to global
             // This is important because of following stack manipulations.
-            P_Context = (P_Context_t*) this->_context;
+            P_Context = P_CopyContext(this->_context);
             P_StackSize = P_Context->size;
 
             // b) Shift stack pointer under the currently restored stack area
@@ -515,7 +788,7 @@ void Process::_Run() noexcept // no exceptions
             // Interrupted process
             // Store content in global variables back to attributes
             P_Context->size = P_StackSize;
-            this->_context = P_Context;
+            this->_context = P_CopyTag(P_Context);
             DEBUG(DBG_PROCESS,("| --- Process::Behavior() INTERRUPT %p.context=%p, size=%d", \
                                                 this, P_Context, P_StackSize));
             P_Context = 0; // cleaning
@@ -601,5 +874,115 @@ void Process::_Run() noexcept // no exceptions
     // return and continue Process::Behavior() execution
 }
 
+#if !SIMLIB_PROCESS_STACK_SWITCH
+
+/**
+ * \fn Process::_Run
+ * Process dispatch method: stack copying only
+ */
+void Process::_Run() noexcept // no exceptions
+{
+    _RunCopy();
+}
+
+#else // SIMLIB_PROCESS_STACK_SWITCH
+
+static thread_local bool P_StackGrown = false;  //!< P_GrowStack() was called
+
+/// Grow the dispatcher stack to the depth used by restore_context() before
+/// any process stack is mapped, later it could fail (address space limit)
+/// for processes with copied stacks
+[[gnu::noinline]] static void P_GrowStack() noexcept
+{
+    volatile char area[MAX_PROCESS_STACK_SIZE + STACK_RESERVED];
+    for (size_t i = 0; i < sizeof(area); i += 4096)
+        area[i] = 0;
+    area[sizeof(area) - 1] = 0;
+}
+
+/**
+ * \fn Process::_Run
+ * Process dispatch method
+ *
+ * The dispatcher starts/reactivates process Behavior() method
+ * on the process's own stack:
+ *  1) allocates and prepares stack at process start
+ *  2) switches to process stack (Behavior() starts or continues)
+ *  3) interruption of Behavior() switches back
+ *  4) terminated process returns the stack to pool
+ * Process without own stack (allocation failed) runs by _RunCopy().
+ *
+ * @ingroup process
+ */
+void Process::_Run() noexcept // no exceptions
+{
+    static const char * status_strings[] = {
+        "unknown", "PREPARED", "RUNNING", "INTERRUPTED", "TERMINATED"
+    };
+    Dprintf(("%016p===Process#%lu._Run() status=%s", this, _Ident, status_strings[_status]));
+
+    if (_status != _INTERRUPTED && _status != _PREPARED)
+        SIMLIB_error(ProcessNotInitialized);
+
+    if (_context != 0 && P_IsCopyContext(_context)) {
+        _RunCopy();             // continue with copied stack
+        return;
+    }
+    P_Stack_t *stack = static_cast<P_Stack_t*>(_context);
+    if (stack == 0) {           // process start
+        if (!P_StackGrown) {
+            P_GrowStack();
+            P_StackGrown = true;
+        }
+        stack = P_StackAlloc();
+        if (stack == 0) {       // no stack available: stack copying
+            _RunCopy();
+            return;
+        }
+        DEBUG(DBG_PROCESS, ("| --- Process::Behavior() START "));
+        P_StackPrepare(stack);
+        _context = stack;
+        P_Starting = this;
+    } else {
+        DEBUG(DBG_PROCESS, ("| --- Process::Behavior() CONTINUE "));
+    }
+
+    _status = _RUNNING;
+    P_Current = stack;
+    P_Finished = false;
+    P_SwitchToProcess(stack);
+    // back from Behavior() - interrupted or terminated
+    P_Current = 0;
+
+    if (P_Finished) {           // Behavior() returned
+        DEBUG(DBG_PROCESS, ("| --- Process::Behavior() END "));
+        _status = _TERMINATED;
+        // Remove from any queue
+        if (Where() != 0) {     // Entity linked in queue
+            Out();              // Remove from queue, no warning
+        }
+        if (!Idle())
+            SQS::Get(this);     // Remove from calendar
+    }
+    if (isTerminated()) {
+        P_StackFree(stack);
+        _context = 0;
+    } else {
+        DEBUG(DBG_PROCESS,("| --- Process::Behavior() INTERRUPT %p.context=%p", this, stack));
+    }
+
+    Dprintf(("%016p===Process#%lu._Run() RETURN status=%s", this, _Ident, status_strings[_status]));
+
+    //TODO: MOVE to simulation control loop
+    if (isTerminated() && isAllocated()) {
+        // terminated process on heap
+        DEBUG(DBG_PROCESS,("| Process %p ends and is deallocated now",this));
+        delete this;    // destroy process
+    }
+    // return to simulation control
+}
+
+#endif // SIMLIB_PROCESS_STACK_SWITCH
+
 } // namespace
 
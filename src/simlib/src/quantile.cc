@@ -0,0 +1,195 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file quantile.cc   Log-linear histogram for quantiles
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+//  QuantileHistogram implementation
+//
+//  Bucket index of value x is computed from the IEEE 754 representation of
+//  v = x/low: the exponent selects the power of two, the top `bits` bits of
+//  the mantissa the linear bucket inside it (no log(), no search).
+//  Quantile estimate is the middle of the bucket, its distance from any
+//  value in the bucket is at most half of the bucket width, i.e.
+//  2^-(bits+1) relative to the value.
+//
+
+////////////////////////////////////////////////////////////////////////////
+// interface
+//
+
+#include "simlib.h"
+#include "internal.h"
+
+#include <cmath>     // ceil(), log2(), ldexp()
+#include <cstring>   // memcpy()
+
+////////////////////////////////////////////////////////////////////////////
+// implementation
+//
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+// LIMIT: maximum number of log-linear buckets (128 MB of counts)
+const unsigned MAXQUANTILEBUCKETS = 1u << 24;
+
+////////////////////////////////////////////////////////////////////////////
+//  constructors
+//
+QuantileHistogram::QuantileHistogram(double l, double h, unsigned b) :
+  dptr(0)
+{
+  Dprintf(("QuantileHistogram::QuantileHistogram(%g,%g,%u)",l,h,b));
+  Init(l, h, b);
+}
+
+QuantileHistogram::QuantileHistogram(const char *n, double l, double h, unsigned b) :
+  dptr(0)
+{
+  Dprintf(("QuantileHistogram::QuantileHistogram(\"%s\",%g,%g,%u)",n,l,h,b));
+  SetName(n);                   // set object name
+  Init(l, h, b);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  destructor
+//
+QuantileHistogram::~QuantileHistogram()
+{
+  Dprintf(("QuantileHistogram::~QuantileHistogram() // \"%s\" ", Name().c_str()));
+  delete[] dptr;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Init --- set layout, high is rounded up to low*2^k
+//
+void QuantileHistogram::Init(double l, double h, unsigned b)
+{
+  Dprintf(("QuantileHistogram::Init(%g,%g,%u)",l,h,b));
+  if (!(l > 0 && h > l) || b > 16)
+    SIMLIB_error(QuantileInitError);
+  double oct = ceil(log2(h / l));
+  if (oct > 1000 || ldexp(oct, b) > MAXQUANTILEBUCKETS)
+    SIMLIB_error(QuantileInitError);
+  unsigned old = dptr ? Buckets() : 0;
+  low = l;
+  scale = 1 / l;
+  bits = b;
+  octaves = unsigned(oct);
+  if (dptr && old != Buckets())
+  {
+    delete[] dptr;
+    dptr = 0;
+  }
+  if (!dptr)
+    dptr = new unsigned long[Buckets() + 2];
+  Clear();
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Clear
+//
+void QuantileHistogram::Clear()
+{
+  Dprintf(("QuantileHistogram::Clear()"));
+  for (unsigned i = 0; i < Buckets() + 2; i++)
+    dptr[i] = 0;
+  n = 0;
+  sx = 0;
+  min = max = 0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  operator ()  - value recording
+//
+void QuantileHistogram::operator () (double x)
+{
+  sx += x;
+  if (++n == 1) min = max = x;
+  else {
+    if (x < min) min = x;
+    if (x > max) max = x;
+  }
+  double v = x * scale;
+  if (!(v >= 1.0)) {                   // below low (or NaN)
+    dptr[0]++;
+    return;
+  }
+  uint64_t u;
+  memcpy(&u, &v, sizeof(u));
+  uint64_t i = (u >> (52 - bits)) - (uint64_t(1023) << bits);
+  if (i >= Buckets())
+    dptr[Buckets() + 1]++;
+  else
+    dptr[i + 1]++;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Merge --- add counts of histogram with the same layout
+//
+void QuantileHistogram::Merge(const QuantileHistogram &h)
+{
+  if (h.low != low || h.bits != bits || h.octaves != octaves)
+    SIMLIB_error(QuantileMergeError);
+  if (h.n == 0)
+    return;
+  for (unsigned i = 0; i < Buckets() + 2; i++)
+    dptr[i] += h.dptr[i];
+  if (n == 0 || h.min < min) min = h.min;
+  if (n == 0 || h.max > max) max = h.max;
+  n += h.n;
+  sx += h.sx;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  BucketLow --- low bound of log-linear bucket i (0..Buckets())
+//
+double QuantileHistogram::BucketLow(unsigned i) const
+{
+  unsigned sub = 1u << bits;
+  return ldexp(low * (sub + (i & (sub - 1))), int(i >> bits) - int(bits));
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Quantile --- value with rank ceil(p*n) (p=0: Min(), p=1: Max())
+//
+double QuantileHistogram::Quantile(double p) const
+{
+  if (!(p >= 0 && p <= 1)) SIMLIB_error(QuantileProbError);
+  if (n == 0) SIMLIB_error(QuantileNoRecError);
+  unsigned long rank = (unsigned long)ceil(p * n);
+  if (rank == 0) return min;
+  if (rank == n) return max;
+  unsigned long s = dptr[0];
+  double x;
+  if (rank <= s)                       // below low
+    x = (min + low) / 2;
+  else {
+    unsigned i = 0;
+    for (; i < Buckets(); i++) {
+      s += dptr[i + 1];
+      if (rank <= s)
+        break;
+    }
+    if (i < Buckets())
+      x = (BucketLow(i) + BucketLow(i + 1)) / 2;
+    else                               // above high
+      x = (High() + max) / 2;
+  }
+  return (x < min) ? min : (x > max) ? max : x;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  QuantileHistogram::MeanValue
+//
+double QuantileHistogram::MeanValue() const
+{
+  if (n == 0) SIMLIB_error(QuantileNoRecError);
+  return sx / n;
+}
+
+}
+// end
@@ -103,7 +103,7 @@ void Queue::PredIns(Entity *ent, iterator pos)
 {
   Dprintf(("%s::PredIns(%s,pos:%p)", Name().c_str(), ent->Name().c_str(), *pos ));
   List::PredIns(ent, *pos); // insert before pos, can be end()
-  ent->_MarkTime = Time;    // marks input time
+  ent->_MarkTime = SIMLIB_Time;    // marks input time
   StatN(size());            // length statistic
 }
 
@@ -134,7 +134,7 @@ Entity *Queue::Get(iterator pos)
 {
   Dprintf(("%s::Get(pos:%p)", Name().c_str(), *pos));
   Entity *ent = static_cast<Entity*>(List::Get(*pos));
-  StatDT(Time - ent->_MarkTime);
+  StatDT(SIMLIB_Time - ent->_MarkTime);
   StatN(size());  StatN.n--; // the number of samples correction
   return ent;
 }
@@ -18,6 +18,8 @@
 #include "simlib.h"
 #include "internal.h"
 
+#include <atomic>
+
 
 ////////////////////////////////////////////////////////////////////////////
 // implementation
@@ -27,13 +29,18 @@ namespace simlib3 {
 
 // external functions
 void   RandomSeed(long seed);     // initialize random number seed
+void   RandomSeed(long seed, unsigned long replication);
 double Random();                  // base uniform generator 0-0.999999...
+void   RandomFill(double *p, std::size_t n); // n numbers of Random()
 void   SetBaseRandomGenerator(double (*new_gen)()); // change base gen.
+double RandomXoshiro256();        // xoshiro256++ base generator
+RandomStream *SetRandomStream(RandomStream *s); // stream of RandomXoshiro256
 
 SIMLIB_IMPLEMENTATION;
 
 
-// TODO: change the basic generator to something better
+// the default generator is kept for compatibility of results,
+// RandomXoshiro256 is better (see RandomStream below)
 
 #if (LONG_MAX<(1ULL<<32))
 typedef long myint32;     // long has 32 bits
@@ -45,7 +52,7 @@ typedef int myint32;      // long has >32 bits
 // some constants for base generator
 //
 
-const myint32 INICONST   = 1537L;
+const myint32 INICONST   = SIMLIB_RANDOM_INICONST;
 const myint32 MULCONST   = 1220703125L;
 // period = 536870912 only!
 
@@ -53,17 +60,33 @@ const myint32 MAXLONGINT = 0x7FFFFFFFUL;
 const myint32 SIGNBIT    = 0x80000000UL;
 
 ////////////////////////////////////////////////////////////////////////////
-// random generator seed
+// random generator seed is SIMLIB_state.RandomSeed (one per context),
+// initial value INICONST
 //
 
-static myint32 SIMLIB_RandomSeed = INICONST ;
-
 ////////////////////////////////////////////////////////////////////////////
 // RandomSeed - initialization of random generator
 //
 void RandomSeed(long seed)
 {
-  SIMLIB_RandomSeed = seed;
+  RandomSeed(seed, 0);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// RandomSeed - initialization of random generator for replication
+// RandomStream generators are reseeded at their next use; epochs are unique
+// in all contexts (a stream used in the next replication context of the
+// thread is reseeded, too)
+//
+static std::atomic<unsigned long> RandomEpochs(1);
+
+void RandomSeed(long seed, unsigned long replication)
+{
+  SIMLIB_State &st = SIMLIB_state;
+  st.RandomSeed = static_cast<myint32>(seed);
+  st.RandomStreamSeed = seed;
+  st.RandomReplication = replication;
+  st.RandomEpoch = ++RandomEpochs;
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -74,18 +97,20 @@ void RandomSeed(long seed)
 //
 double SIMLIB_RandomBase()  // range <0..1)
 {
-  SIMLIB_RandomSeed *= MULCONST;
-  SIMLIB_RandomSeed &= MAXLONGINT; // strip sign bit
-//  _Print("random=%lx\n", (long)SIMLIB_RandomSeed);
-  double r = static_cast<double>(SIMLIB_RandomSeed)/MAXLONGINT;
+  myint32 seed = static_cast<myint32>(SIMLIB_state.RandomSeed);
+  seed *= MULCONST;
+  seed &= MAXLONGINT; // strip sign bit
+//  _Print("random=%lx\n", (long)seed);
+  SIMLIB_state.RandomSeed = seed;
+  double r = static_cast<double>(seed)/MAXLONGINT;
   // assert: if( r<0.0 || r>=1.0 ) SIMLIB_error("Random() out of range");
   return r;
 }
 
 ////////////////////////////////////////////////////////////////////////////
-// pointer to base generator
+// pointer to base generator is SIMLIB_state.RandomBase (one per context),
+// initial value SIMLIB_RandomBase
 //
-static double (*SIMLIB_RandomBasePtr)() = SIMLIB_RandomBase;
 
 ////////////////////////////////////////////////////////////////////////////
 // Random --- base uniform random number generator
@@ -94,7 +119,7 @@ static double (*SIMLIB_RandomBasePtr)() = SIMLIB_RandomBase;
 //
 double Random()
 {
-  return SIMLIB_RandomBasePtr();
+  return SIMLIB_state.RandomBase();
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -103,9 +128,184 @@ double Random()
 void SetBaseRandomGenerator(double (*new_gen)())
 {
   if(new_gen)
-    SIMLIB_RandomBasePtr = new_gen;
+    SIMLIB_state.RandomBase = new_gen;
+  else
+    SIMLIB_state.RandomBase = SIMLIB_RandomBase; // default value
+}
+
+////////////////////////////////////////////////////////////////////////////
+// RandomFill --- n numbers of Random()
+//
+// the same sequence as n calls of Random(), built-in generators
+// are called directly (no call by pointer for each number)
+//
+void RandomFill(double *p, std::size_t n)
+{
+  SIMLIB_State &st = SIMLIB_state;
+  if(st.RandomBase == SIMLIB_RandomBase) {
+    myint32 seed = static_cast<myint32>(st.RandomSeed);
+    for(std::size_t i = 0; i < n; i++) {
+      seed *= MULCONST;
+      seed &= MAXLONGINT;
+      p[i] = static_cast<double>(seed)/MAXLONGINT;
+    }
+    st.RandomSeed = seed;
+  }
+  else if(st.RandomBase == RandomXoshiro256)
+    (st.RandomActive ? *st.RandomActive : st.RandomDefault).Fill(p, n);
   else
-    SIMLIB_RandomBasePtr = SIMLIB_RandomBase; // default value
+    for(std::size_t i = 0; i < n; i++)
+      p[i] = st.RandomBase();
+}
+
+
+////////////////////////////////////////////////////////////////////////////
+// xoshiro256++ generator (D. Blackman, S. Vigna, 2019)
+//
+// 256 bit state, period 2^256-1, jump functions by precomputed
+// polynomials; SplitMix64 is used to initialize the state from the seed
+//
+
+static inline uint64_t rotl(uint64_t x, int k)
+{
+  return (x << k) | (x >> (64 - k));
+}
+
+// SplitMix64 --- next value of sequence x (used for seeding only)
+static uint64_t SplitMix64(uint64_t &x)
+{
+  uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// one step of generator
+static inline uint64_t Xoshiro256pp(uint64_t *s)
+{
+  const uint64_t result = rotl(s[0] + s[3], 23) + s[0];
+  const uint64_t t = s[1] << 17;
+  s[2] ^= s[0];
+  s[3] ^= s[1];
+  s[1] ^= s[2];
+  s[0] ^= s[3];
+  s[2] ^= t;
+  s[3] = rotl(s[3], 45);
+  return result;
+}
+
+// 53 random bits to range <0..1)
+static inline double ToDouble(uint64_t x)
+{
+  return static_cast<double>(x >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// jump by polynomial (advance 2^128 or 2^192 steps)
+static void XoshiroJump(uint64_t *s, const uint64_t *poly)
+{
+  uint64_t t[4] = { 0, 0, 0, 0 };
+  for(int i = 0; i < 4; i++)
+    for(int b = 0; b < 64; b++) {
+      if(poly[i] & (1ULL << b)) {
+        t[0] ^= s[0];
+        t[1] ^= s[1];
+        t[2] ^= s[2];
+        t[3] ^= s[3];
+      }
+      Xoshiro256pp(s);
+    }
+  for(int i = 0; i < 4; i++)
+    s[i] = t[i];
+}
+
+static const uint64_t JUMP[4] = {
+  0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+  0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL };
+static const uint64_t LONG_JUMP[4] = {
+  0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL,
+  0x77710069854ee241ULL, 0x39109bb02acbe635ULL };
+
+////////////////////////////////////////////////////////////////////////////
+// RandomStream --- named stream, the key is FNV-1a hash of the name
+//
+RandomStream::RandomStream(const char *name) : s{0,0,0,0}, key(0), epoch(0)
+{
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for(const char *p = name; *p; p++) {
+    h ^= static_cast<unsigned char>(*p);
+    h *= 0x100000001b3ULL;
+  }
+  key = h;
+}
+
+// replication r takes r-th block of four SplitMix64 values (O(1) for any r)
+void RandomStream::Seed(unsigned long seed, unsigned long replication)
+{
+  uint64_t x = (static_cast<uint64_t>(seed) ^ key)
+             + 4 * static_cast<uint64_t>(replication) * 0x9e3779b97f4a7c15ULL;
+  for(int i = 0; i < 4; i++)
+    s[i] = SplitMix64(x);
+  epoch = SIMLIB_state.RandomEpoch;
+}
+
+// seed by the last RandomSeed() of the context
+void RandomStream::Reseed()
+{
+  const SIMLIB_State &st = SIMLIB_state;
+  Seed(static_cast<unsigned long>(st.RandomStreamSeed), st.RandomReplication);
+}
+
+uint64_t RandomStream::Next64()
+{
+  if(epoch != SIMLIB_state.RandomEpoch)
+    Reseed();
+  return Xoshiro256pp(s);
+}
+
+double RandomStream::operator()()
+{
+  return ToDouble(Next64());
+}
+
+void RandomStream::Fill(double *p, std::size_t n)
+{
+  if(epoch != SIMLIB_state.RandomEpoch)
+    Reseed();
+  for(std::size_t i = 0; i < n; i++)
+    p[i] = ToDouble(Xoshiro256pp(s));
+}
+
+void RandomStream::Jump()
+{
+  if(epoch != SIMLIB_state.RandomEpoch)
+    Reseed();
+  XoshiroJump(s, JUMP);
+}
+
+void RandomStream::LongJump()
+{
+  if(epoch != SIMLIB_state.RandomEpoch)
+    Reseed();
+  XoshiroJump(s, LONG_JUMP);
+}
+
+////////////////////////////////////////////////////////////////////////////
+// RandomXoshiro256 --- base generator using selected stream of context
+//
+double RandomXoshiro256()
+{
+  SIMLIB_State &st = SIMLIB_state;
+  return st.RandomActive ? (*st.RandomActive)() : st.RandomDefault();
+}
+
+////////////////////////////////////////////////////////////////////////////
+// SetRandomStream --- select stream of RandomXoshiro256, returns previous
+//
+RandomStream *SetRandomStream(RandomStream *s)
+{
+  RandomStream *previous = SIMLIB_state.RandomActive;
+  SIMLIB_state.RandomActive = s;
+  return previous;
 }
 
 }
@@ -74,13 +74,115 @@ double Uniform(double l, double h)
   return(l+(h-l)*Random());
 }
 
+////////////////////////////////////////////////////////////////////////////
+//  SetRandomCompatibility --- select methods of Normal and Exponential
+//
+void SetRandomCompatibility(bool on)
+{
+  SIMLIB_state.RandomCompat = on;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Ziggurat method (G. Marsaglia, W. W. Tsang, 2000)
+//
+//  the density f is covered by N layers of equal area V: the base layer
+//  (rectangle 0..R and the tail x>R) and N-1 rectangles. A point is drawn
+//  in a random layer, inside the part under the curve (most cases) it is
+//  accepted by one comparison, only the wedges and the tail need exp/log.
+//  Layer number, sign and position are taken from one Random() number.
+//
+//  tables: x[0] = V/f(R), x[1] = R, x[i+1] = f^-1(V/x[i] + f(x[i])),
+//          x[N] = 0, fx[i] = f(x[i])
+//
+struct ZigguratNormalTable {            // f(x) = exp(-x*x/2), x>=0
+  static const int N = 128;
+  static constexpr double R = 3.442619855899;
+  static constexpr double V = 9.91256303526217e-3;
+  double x[N+1], fx[N+1];
+  ZigguratNormalTable() {
+    x[0] = V / std::exp(-0.5*R*R);
+    x[1] = R;
+    for (int i=1; i<N-1; i++)
+      x[i+1] = std::sqrt(-2.0 * std::log(V/x[i] + std::exp(-0.5*x[i]*x[i])));
+    x[N] = 0.0;
+    for (int i=0; i<=N; i++)
+      fx[i] = std::exp(-0.5*x[i]*x[i]);
+  }
+};
+
+struct ZigguratExponentialTable {       // f(x) = exp(-x), x>=0
+  static const int N = 256;
+  static constexpr double R = 7.697117470131487;
+  static constexpr double V = 3.949659822581572e-3;
+  double x[N+1], fx[N+1];
+  ZigguratExponentialTable() {
+    x[0] = V / std::exp(-R);
+    x[1] = R;
+    for (int i=1; i<N-1; i++)
+      x[i+1] = -std::log(V/x[i] + std::exp(-x[i]));
+    x[N] = 0.0;
+    for (int i=0; i<=N; i++)
+      fx[i] = std::exp(-x[i]);
+  }
+};
+
+// standard normal distribution N(0,1)
+static double ZigguratNormal()
+{
+  typedef ZigguratNormalTable Z;
+  static const Z z;                     // initialized at first use
+  for (;;) {
+    double r = Random() * (2*Z::N);
+    int j = int(r);
+    int i = j & (Z::N-1);               // layer
+    double x = (r - j) * z.x[i];
+    if (x >= z.x[i+1]) {
+      if (i == 0) {                     // tail x>R (Marsaglia 1964)
+        double a, b;
+        do {
+          a = -std::log(1.0-Random()) / Z::R;
+          b = -std::log(1.0-Random());
+        } while (b+b < a*a);
+        x = Z::R + a;
+      }
+      else if (z.fx[i] + Random()*(z.fx[i+1]-z.fx[i]) >= std::exp(-0.5*x*x))
+        continue;                       // outside wedge
+    }
+    return (j & Z::N) ? -x : x;         // sign
+  }
+}
+
+// exponential distribution with mean value 1
+static double ZigguratExponential()
+{
+  typedef ZigguratExponentialTable Z;
+  static const Z z;                     // initialized at first use
+  double tail = 0.0;
+  for (;;) {
+    double r = Random() * Z::N;
+    int i = int(r) & (Z::N-1);          // layer
+    double x = (r - int(r)) * z.x[i];
+    if (x < z.x[i+1])
+      return tail + x;
+    if (i == 0)                         // tail x>R: R + Exp(1)
+      tail += Z::R;
+    else if (z.fx[i] + Random()*(z.fx[i+1]-z.fx[i]) < std::exp(-x))
+      return tail + x;
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////
 //  Normal(mi,sigma)
 //  mi    = mean value
 //  sigma = std deviation? (smerodatna odchylka) ###
 //
+//  ziggurat method, compatibility: sum of 12 Random() numbers
+//  (approximation, |x-mi| < 6*sigma)
+//
 double Normal(double mi, double sigma)
 {
+  if (!SIMLIB_state.RandomCompat)
+    return ZigguratNormal()*sigma + mi;
   int i;
   double SUM = 0.0;
   for (i=0; i<12; i++)  SUM += Random();
@@ -149,8 +251,12 @@ double Gamma(double alfa, double beta)
 ////////////////////////////////////////////////////////////////////////////
 //  Exponential(mv)
 //
+//  ziggurat method, compatibility: inversion -mv*log(1-Random())
+//
 double Exponential(double mv)
 {
+  if (!SIMLIB_state.RandomCompat)
+    return mv * ZigguratExponential();
   double exp = -mv * std::log(1.0-Random());
 //  _Print("Exponential(%g),%g = %g\n", mv, r, exp);
   return exp;
@@ -223,11 +329,87 @@ double Rayle(double delta)
   return  delta * sqrt(-log(R));
 }
 
+////////////////////////////////////////////////////////////////////////////
+//  log(k!) by Stirling formula with correction fc(k) (W. Hoermann, 1993)
+//
+//  log(k!) = (k+1/2)*log(k+1) - (k+1) + log(sqrt(2*pi)) + fc(k)
+//
+static double StirlingCorrection(long k)
+{
+  static const double fc[10] = {
+    0.08106146679532726, 0.04134069595540929, 0.02767792568499834,
+    0.02079067210376509, 0.01664469118982119, 0.01387612882307075,
+    0.01189670994589177, 0.01041126526197209, 0.009255462182712733,
+    0.008330563433362871 };
+  if (k < 10)
+    return fc[k];
+  double r = 1.0/(k+1);
+  double rr = r*r;
+  return (1.0/12 - (1.0/360 - 1.0/1260*rr)*rr)*r;
+}
+
+static double LogFactorial(long k)
+{
+  return (k+0.5)*log(k+1.0) - (k+1) + 0.91893853320467274 + StirlingCorrection(k);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  Poisson sampler: inversion for lambda<10, otherwise transformed
+//  rejection with squeeze PTRS (W. Hoermann, 1993), O(1) expected time
+//  setup is done once for PoissonFill
+//
+class PoissonSampler {
+  double lambda;
+  double loglam, b, a, invalpha, vr, expl;
+ public:
+  PoissonSampler(double l) : lambda(l) {
+    if (lambda <= 0) SIMLIB_error(PoissonError);
+    if (lambda < 10) {
+      expl = exp(-lambda);
+      return;
+    }
+    loglam = log(lambda);
+    b = 0.931 + 2.53*sqrt(lambda);
+    a = -0.059 + 0.02483*b;
+    invalpha = 1.1239 + 1.1328/(b-3.4);
+    vr = 0.9277 - 3.6224/(b-2);
+  }
+  int operator()() const {
+    if (lambda < 10) {                  // inversion (sequential search)
+      double p = expl, F = p;
+      double u = Random();
+      int k = 0;
+      while (u > F && k < 100) {        // 100: only rounding errors remain
+        p *= lambda/++k;
+        F += p;
+      }
+      return k;
+    }
+    for (;;) {
+      double U = Random() - 0.5;
+      double V = Random();
+      double us = 0.5 - fabs(U);
+      long k = long(floor((2*a/us + b)*U + lambda + 0.43));
+      if (us >= 0.07 && V <= vr)        // squeeze
+        return k;
+      if (k < 0 || (us < 0.013 && V > us))
+        continue;
+      if (log(V) + log(invalpha) - log(a/(us*us) + b) <= -lambda + k*loglam - LogFactorial(k))
+        return k;
+    }
+  }
+};
+
 ////////////////////////////////////////////////////////////////////////////
 //  Poisson(double lambda)
 //
+//  PTRS method, compatibility: multiplication method for lambda<=9,
+//  otherwise rounded Normal() (approximation)
+//
 int Poisson(double lambda)
 {
+  if (!SIMLIB_state.RandomCompat)
+    return PoissonSampler(lambda)();
   double Y,X;
   int PSSN = 0;
   if (lambda<=0) SIMLIB_error(PoissonError);
@@ -251,6 +433,21 @@ int Poisson(double lambda)
   return PSSN;
 }
 
+////////////////////////////////////////////////////////////////////////////
+//  PoissonFill --- n numbers of Poisson(lambda)
+//
+void PoissonFill(double lambda, int *p, std::size_t n)
+{
+  if (SIMLIB_state.RandomCompat) {
+    for (std::size_t i = 0; i < n; i++)
+      p[i] = Poisson(lambda);
+    return;
+  }
+  const PoissonSampler poisson(lambda);
+  for (std::size_t i = 0; i < n; i++)
+    p[i] = poisson();
+}
+
 ////////////////////////////////////////////////////////////////////////////
 //  Geom(q)
 //
@@ -287,30 +484,122 @@ int HyperGeom(double p, int n, int m)
   return (IX);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//  Binomial sampler: inversion for n*min(p,1-p)<10, otherwise
+//  transformed rejection BTRD (W. Hoermann, 1993), O(1) expected time;
+//  p>1/2 is computed as n - X(n, 1-p); setup is done once for BinomFill
+//
+class BinomSampler {
+  int n;
+  bool flip;                            // p>1/2
+  double p, q;
+  double m, r, nr, npq, b, a, c, alpha, vr, urvr, h;
+  int Inversion() const {
+    double s = p/q, an = (n+1)*s;
+    double f = pow(q, n);
+    double u = Random();
+    int k = 0;
+    while (u > f && k < n) {
+      u -= f;
+      k++;
+      f *= an/k - s;
+    }
+    return k;
+  }
+  int BTRD() const {
+    for (;;) {
+      double u, v = Random();
+      if (v <= urvr) {                  // inside the triangle
+        u = v/vr - 0.43;
+        return int(floor((2*a/(0.5-fabs(u)) + b)*u + c));
+      }
+      if (v >= vr)
+        u = Random() - 0.5;
+      else {
+        u = v/vr - 0.93;
+        u = ((u > 0) ? 0.5 : -0.5) - u;
+        v = Random()*vr;
+      }
+      double us = 0.5 - fabs(u);
+      long k = long(floor((2*a/us + b)*u + c));
+      if (k < 0 || k > n)
+        continue;
+      v = v*alpha/(a/(us*us) + b);
+      long km = labs(k - long(m));
+      if (km <= 15) {                   // recursive evaluation of f(k)
+        double f = 1.0;
+        if (m < k)
+          for (long i = long(m)+1; i <= k; i++)
+            f *= nr/i - r;
+        else
+          for (long i = k+1; i <= long(m); i++)
+            v *= nr/i - r;
+        if (v <= f)
+          return int(k);
+        continue;
+      }
+      v = log(v);                       // squeeze
+      double rho = (km/npq)*(((km/3.0 + 0.625)*km + 1.0/6)/npq + 0.5);
+      double t = -km*double(km)/(2*npq);
+      if (v < t - rho)
+        return int(k);
+      if (v > t + rho)
+        continue;
+      double nk = n - k + 1;
+      if (v <= h + (n+1)*log((n-m+1)/nk) + (k+0.5)*log(nk*r/(k+1))
+                 - StirlingCorrection(k) - StirlingCorrection(n-k))
+        return int(k);
+    }
+  }
+ public:
+  BinomSampler(int trials, double prob) : n(trials) {
+    if (n < 0 || prob < 0 || prob > 1) SIMLIB_error(BinomError);
+    flip = prob > 0.5;
+    p = flip ? 1 - prob : prob;
+    q = 1 - p;
+    if (n*p < 10)
+      return;
+    m = floor((n+1)*p);
+    r = p/q;
+    nr = (n+1)*r;
+    npq = n*p*q;
+    double snpq = sqrt(npq);
+    b = 1.15 + 2.53*snpq;
+    a = -0.0873 + 0.0248*b + 0.01*p;
+    c = n*p + 0.5;
+    alpha = (2.83 + 5.1/b)*snpq;
+    vr = 0.92 - 4.2/b;
+    urvr = 0.86*vr;
+    h = (m+0.5)*log((m+1)/(r*(n-m+1))) + StirlingCorrection(long(m))
+        + StirlingCorrection(long(n-m));
+  }
+  int operator()() const {
+    if (p == 0)
+      return flip ? n : 0;
+    int k = (n*p < 10) ? Inversion() : BTRD();
+    return flip ? n - k : k;
+  }
+};
+
 ////////////////////////////////////////////////////////////////////////////
-//  Binom(n,theta)
+//  Binom(n,p)
 //  n     = # of experiments (pocet pokusu)
-//  theta = probability
+//  p     = probability
 //
-/*
-int Binom(unsigned n, double theta)
+int Binom(int n, double p)
 {
-  int BNM;
-  double SUM,R,TT,x;
-  if (theta<0 || theta>1) SIMLIB_error(BinomError);
-  SUM = R = pow(1-theta,n);
-  TT = theta/(1-theta);
-  BNM = 0;
-  x = Random();
-  while(x-SUM > 0)
-  {
-    R *= (n-BNM)/(BNM+1)*TT;
-    SUM += R;
-    BNM++;
-  }
-  return (BNM);
+  return BinomSampler(n, p)();
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  BinomFill --- count numbers of Binom(n,p)
+//
+void BinomFill(int n, double p, int *a, std::size_t count)
+{
+  const BinomSampler binom(n, p);
+  for (std::size_t i = 0; i < count; i++)
+    a[i] = binom();
 }
-*/
 
 } // end
 
@@ -0,0 +1,297 @@
+/////////////////////////////////////////////////////////////////////////////
+//! \file report.cc   Structured output of statistics objects
+//
+// This library is licensed under GNU Library GPL. See the file COPYING.
+//
+
+//
+//  OutputFormatter implementations, list of objects for OutputStatistics()
+//
+//  Report() methods of objects call the formatter (BeginObject, Field...,
+//  nested objects, EndObject), formatter appends the data to its buffer.
+//  The whole report is written by single write to the output file.
+//
+//  "json"   one line per report:
+//           {"time":T,"objects":[{"type":"stat","name":"S","n":...},...]}
+//           numbers in %.17g (exact), NaN and infinity as null
+//
+//  "binary" "SIMLIBR1", double time, records, 'Z'
+//           record: uint8 tag, key (uint8 length, bytes; empty at top level)
+//             'O'  object: type (uint8 length, bytes), name (uint32 length,
+//                  bytes), records of fields and nested objects, 'E'
+//             'd'  double          'u'  uint64
+//             's'  uint32 length, bytes
+//             'a'  uint32 n, n * uint64
+//           numbers in native byte order (little-endian on x86)
+//
+
+////////////////////////////////////////////////////////////////////////////
+// interface
+//
+
+#include "simlib.h"
+#include "internal.h"
+
+#include <cmath>     // std::isfinite()
+#include <cstdio>    // snprintf()
+#include <cstring>   // strcmp(), strlen()
+#include <vector>
+
+////////////////////////////////////////////////////////////////////////////
+// implementation
+//
+
+namespace simlib3 {
+
+SIMLIB_IMPLEMENTATION;
+
+////////////////////////////////////////////////////////////////////////////
+//  JSON formatter
+//
+class JsonFormatter : public OutputFormatter {
+  std::vector<bool> first;      // no item yet at this level
+  void Separator() {
+    if (!first.back()) data += ',';
+    first.back() = false;
+  }
+  void String(const char *s, size_t len) {
+    data += '"';
+    for (size_t i = 0; i < len; i++) {
+      unsigned char c = s[i];
+      if (c == '"' || c == '\\') {
+        data += '\\';
+        data += c;
+      } else if (c < 0x20) {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "\\u%04x", c);
+        data += buf;
+      } else
+        data += c;
+    }
+    data += '"';
+  }
+  void Key(const char *key) {
+    Separator();
+    if (key) {
+      String(key, strlen(key));
+      data += ':';
+    }
+  }
+  void Number(double x) {
+    if (!std::isfinite(x)) {
+      data += "null";
+      return;
+    }
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.17g", x);
+    data += buf;
+  }
+  void Number(unsigned long x) {
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%lu", x);
+    data += buf;
+  }
+ public:
+  void Begin(double time) override {
+    data += "{\"time\":";
+    Number(time);
+    data += ",\"objects\":[";
+    first.assign(1, true);
+  }
+  void BeginObject(const char *key, const char *type, const std::string &name) override {
+    Key(key);
+    data += '{';
+    first.push_back(true);
+    Field("type", std::string(type));
+    Field("name", name);
+  }
+  void Field(const char *key, double x) override {
+    Key(key);
+    Number(x);
+  }
+  void Field(const char *key, unsigned long x) override {
+    Key(key);
+    Number(x);
+  }
+  void Field(const char *key, const std::string &s) override {
+    Key(key);
+    String(s.data(), s.size());
+  }
+  void Array(const char *key, const unsigned long *a, unsigned n) override {
+    Key(key);
+    data += '[';
+    for (unsigned i = 0; i < n; i++) {
+      if (i) data += ',';
+      Number(a[i]);
+    }
+    data += ']';
+  }
+  void EndObject() override {
+    data += '}';
+    first.pop_back();
+  }
+  void End() override {
+    data += "]}\n";
+    first.clear();
+  }
+};
+
+////////////////////////////////////////////////////////////////////////////
+//  binary formatter
+//
+class BinaryFormatter : public OutputFormatter {
+  template <typename T> void Put(T x) {
+    data.append(reinterpret_cast<const char*>(&x), sizeof(x));
+  }
+  void Key(char tag, const char *key) {
+    size_t len = key ? strlen(key) : 0;
+    if (len > 255) len = 255;
+    data += tag;
+    Put(uint8_t(len));
+    data.append(key ? key : "", len);
+  }
+ public:
+  void Begin(double time) override {
+    data += "SIMLIBR1";
+    Put(time);
+  }
+  void BeginObject(const char *key, const char *type, const std::string &name) override {
+    Key('O', key);
+    size_t len = strlen(type);
+    Put(uint8_t(len));
+    data.append(type, len);
+    Put(uint32_t(name.size()));
+    data += name;
+  }
+  void Field(const char *key, double x) override {
+    Key('d', key);
+    Put(x);
+  }
+  void Field(const char *key, unsigned long x) override {
+    Key('u', key);
+    Put(uint64_t(x));
+  }
+  void Field(const char *key, const std::string &s) override {
+    Key('s', key);
+    Put(uint32_t(s.size()));
+    data += s;
+  }
+  void Array(const char *key, const unsigned long *a, unsigned n) override {
+    Key('a', key);
+    Put(uint32_t(n));
+    for (unsigned i = 0; i < n; i++)
+      Put(uint64_t(a[i]));
+  }
+  void EndObject() override { data += 'E'; }
+  void End() override { data += 'Z'; }
+};
+
+////////////////////////////////////////////////////////////////////////////
+//  CreateOutputFormatter
+//
+OutputFormatter *CreateOutputFormatter(const char *format)
+{
+  if (strcmp(format, "json") == 0)
+    return new JsonFormatter;
+  if (strcmp(format, "binary") == 0)
+    return new BinaryFormatter;
+  return nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  SimObject::Report --- default: type and name only
+//
+void SimObject::Report(OutputFormatter &f, const char *key) const
+{
+  f.BeginObject(key, "object", Name());
+  f.EndObject();
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  list of registered objects (per thread, as model objects)
+//
+static SIMLIB_THREAD_LOCAL std::vector<SimObject*> *output_list = nullptr;
+
+// format of OutputStatistics(), "text" by default (as OutFile, not per thread)
+static std::string output_format = "text";
+
+void OutputRegister(SimObject &o)
+{
+  if (o.TestAndSetFlag(true, SimObject::_REPORT_FLAG))
+    return;                             // already registered
+  if (!output_list)
+    output_list = new std::vector<SimObject*>;
+  output_list->push_back(&o);
+}
+
+void OutputUnregister(SimObject &o)
+{
+  if (o.TestAndSetFlag(false, SimObject::_REPORT_FLAG))
+    SIMLIB_OutputUnregister(&o);
+}
+
+void SIMLIB_OutputUnregister(SimObject *o)
+{
+  if (!output_list)
+    return;
+  for (size_t i = output_list->size(); i-- > 0;) {
+    if ((*output_list)[i] == o) {
+      output_list->erase(output_list->begin() + i);
+      break;
+    }
+  }
+  if (output_list->empty()) {
+    delete output_list;
+    output_list = nullptr;
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  SetOutputFormat
+//
+void SetOutputFormat(const char *format)
+{
+  if (strcmp(format, "text") != 0) {
+    OutputFormatter *f = CreateOutputFormatter(format);
+    if (!f)
+      SIMLIB_error(OutputFormatError);
+    delete f;
+  }
+  output_format = format;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  ReportStatistics --- report of all registered objects
+//
+std::string ReportStatistics(const char *format)
+{
+  OutputFormatter *f = CreateOutputFormatter(format);
+  if (!f)
+    SIMLIB_error(OutputFormatError);
+  f->Begin(SIMLIB_Time);
+  if (output_list)
+    for (SimObject *o : *output_list)
+      o->Report(*f);
+  f->End();
+  std::string data = f->Data();
+  delete f;
+  return data;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  OutputStatistics
+//
+void OutputStatistics()
+{
+  if (output_format == "text") {
+    if (output_list)
+      for (SimObject *o : *output_list)
+        o->Output();
+    return;
+  }
+  if (!SIMLIB_OutputWrite(ReportStatistics(output_format.c_str())))
+    SIMLIB_error(OutFilePutError);
+}
+
+}
+// end
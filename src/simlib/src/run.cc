@@ -29,42 +29,14 @@ namespace simlib3 {
 SIMLIB_IMPLEMENTATION;
 
 ////////////////////////////////////////////////////////////////////////////
-//  SIMLIB global variables  ### move to extra module!!!
+//  SIMLIB global variables are in context.cc (SimulationContext)
 //
 //  SIMLIB_*  --- internal variables
 //  [A-Z]*    --- user-level variables
 //
 
-
-// time-related variables
-double SIMLIB_StartTime;       // time of simulation start
-double SIMLIB_Time;            // simulation time
-double SIMLIB_NextTime;        // next-event time
-double SIMLIB_EndTime;         // time of simulation end
-
-// read-only references to time variables
-// ASSERTION: StartTime <= Time <= NextTime <= EndTime
-const double & StartTime = SIMLIB_StartTime;    // time of simulation start
-const double & Time      = SIMLIB_Time;         // simulation time
-const double & NextTime  = SIMLIB_NextTime;     // next-event time
-const double & EndTime   = SIMLIB_EndTime;      // time of simulation end
-
-// current entity pointer
-Entity *SIMLIB_Current = NULL;
-Entity *const &Current = SIMLIB_Current;        // read-only reference
-
-// phase of simulation experiment
-SIMLIB_Phase_t SIMLIB_Phase = START;
-const SIMLIB_Phase_t & Phase = SIMLIB_Phase;    // read-only reference
-
-// experiment counter
-unsigned long SIMLIB_experiment_no = 0;
-
 ////////////////////////////////////////////////////////////////////////////
 /// internal statistical information
-SIMLIB_statistics_t::SIMLIB_statistics_t() {
-    Init();
-}
 void SIMLIB_statistics_t::Init() {
     StepCount = 0;
     MinStep = -1;
@@ -72,16 +44,11 @@ void SIMLIB_statistics_t::Init() {
     EventCount = 0;
     StartTime = -1;
     EndTime = -1;
+    EventNoticeAllocs = 0;
+    EventNoticeMaxLive = EventNoticeLive;  // current state is kept
+    EventNoticeChunksFreed = 0;
 }
 
-static SIMLIB_statistics_t SIMLIB_run_statistics;
-const SIMLIB_statistics_t &SIMLIB_statistics = SIMLIB_run_statistics;
-
-////////////////////////////////////////////////////////////////////////////
-// private module variables
-
-static bool StopFlag = false;           // if set, stop simulation run
-
 ////////////////////////////////////////////////////////////////////////////
 // support for Delay blocks (internal)
 //
@@ -130,7 +97,7 @@ void SIMLIB_WUClear() // should be removed -- ise CALL_HOOK instead
 DEFINE_HOOK(WUget_next);
 ////////////////////////////////////////////////////////////////////////////
 // SIMLIB_DoActions --- central calling of interruptable procedures
-// WARNING: SIMLIB_Current->_Run() should be called from this place only!
+// WARNING: Current->_Run() should be called from this place only!
 //
 void SIMLIB_DoActions()
 {
@@ -147,9 +114,9 @@ void SIMLIB_DoActions()
 void Stop()
 {
     Dprintf(("\n ********************* STOP *********************\n"));
-    if( SIMLIB_Phase != SIMULATION ) // if runs a simulation experiment
+    if( Phase != SIMULATION ) // if runs a simulation experiment
         SIMLIB_error(SFunctionUseError);
-    StopFlag = true;
+    SIMLIB_state.StopFlag = true;
 }
 
 
@@ -159,7 +126,7 @@ void Stop()
 void Abort()
 {
     Dprintf(("\n ********************* ABORT *********************\n"));
-    SIMLIB_Phase = ERROREXIT;
+    Phase = ERROREXIT;
     std::exit(1); // end of program, errorcode 1
 }
 
@@ -176,9 +143,9 @@ void Abort()
 //
 void SIMLIB_Init(double T0, double T1, unsigned version)
 {
-  ++SIMLIB_experiment_no;
+  ++SIMLIB_state.experiment_no;
   Dprintf(("\n\t ************************* Init(%g,%g) #%lu \n",
-           T0, T1, SIMLIB_experiment_no));
+           T0, T1, SIMLIB_state.experiment_no));
   // first some checks
   if(version != SIMLIB_version) {  // check versions
     Dprintf(("\n SIMLIB library version %x.%02x ",
@@ -187,18 +154,18 @@ void SIMLIB_Init(double T0, double T1, unsigned version)
               version >> 8, version & 0xFF));
     SIMLIB_error(InconsistentHeader);  // exit program
   }
-  if( SIMLIB_Phase == INITIALIZATION ) SIMLIB_error(TwiceInitError);
-  if( SIMLIB_Phase == SIMULATION ) SIMLIB_error(InitInRunError);
-  SIMLIB_Phase = INITIALIZATION;
+  if( Phase == INITIALIZATION ) SIMLIB_error(TwiceInitError);
+  if( Phase == SIMULATION ) SIMLIB_error(InitInRunError);
+  Phase = INITIALIZATION;
   /////////////////////////////////////////////////////////////////
   if( T0 < SIMLIB_MINTIME ) SIMLIB_error(InitError);
   if( T1 > SIMLIB_MAXTIME ) SIMLIB_error(InitError);
   if( T0 >= T1 )            SIMLIB_error(InitError);
   /////////////////////////////////////////////////////////////////
   // set simulation parameters
-  _SetTime(StartTime,T0);
-  _SetTime(Time,T0);
-  _SetTime(EndTime,T1);
+  _SetTime(SIMLIB_StartTime,T0);
+  _SetTime(SIMLIB_Time,T0);
+  _SetTime(SIMLIB_EndTime,T1);
 
 // set reasonable defaults for Step limits ???
 // if not set by user first ### add flag to SetStep
@@ -214,6 +181,7 @@ void SIMLIB_Init(double T0, double T1, unsigned version)
 
   SQS::Clear();                 // initialize calendar
   SIMLIB_WUClear();             // initialize WaitUntilList
+  SIMLIB_ObjectPoolTrim();      // free memory of deleted objects
   SIMLIB_ContinueInit();        // initialize status variables 1 ###
 
   CALL_HOOK(SamplerInit);       // initialize all Samplers
@@ -229,19 +197,19 @@ void Run() {
   Dprintf(("\n\t ********** Run() --- START \n"));
 
   // first some checks
-  if( SIMLIB_Phase != INITIALIZATION )
+  if( Phase != INITIALIZATION )
       SIMLIB_error(RunUseError); // bad use of Run()
-  if( NextTime < StartTime )
+  if( SIMLIB_NextTime < SIMLIB_StartTime )
       SIMLIB_internal_error();   // never reached
 
   // welcome to the SIMLIB simulation control algorithm :-)
 
   // initialize variables
-  SIMLIB_Phase = SIMULATION;
-  StopFlag = false;               // flag for stop simulation
+  Phase = SIMULATION;
+  SIMLIB_state.StopFlag = false;  // flag for stop simulation
 
-  SIMLIB_run_statistics.Init();       // initialize internal statistics
-  SIMLIB_run_statistics.StartTime = Time;
+  SIMLIB_statistics.Init();       // initialize internal statistics
+  SIMLIB_statistics.StartTime = SIMLIB_Time;
 
   // call init functions
   SIMLIB_ContinueInit();          // initialize status variables 2 ###
@@ -254,43 +222,43 @@ void Run() {
 //       It should be simpler
 
   // main loop
-  while( Time < EndTime && !StopFlag )  {
-      int endFlag = NextTime > EndTime; // if no event at end time
+  while( SIMLIB_Time < SIMLIB_EndTime && !SIMLIB_state.StopFlag )  {
+      int endFlag = SIMLIB_NextTime > SIMLIB_EndTime; // if no event at end time
       if( endFlag )
-          _SetTime( NextTime, EndTime ); // limit NextTime to EndTime
+          _SetTime( SIMLIB_NextTime, SIMLIB_EndTime ); // limit NextTime to EndTime
 
-      if( Time < NextTime )  {  // no event at current Time
+      if( SIMLIB_Time < SIMLIB_NextTime )  {  // no event at current Time
           if( IntegratorContainer::isAny() || StatusContainer::isAny() ) {
               // there are integrators or status variables, so we enter
               // -------------- CONTINUOUS SIMULATION ---------------
               SIMLIB_ResetStatus = true;   // don't use previous step buffers
                                            // TODO: is it really needed always?
               CALL_HOOK(Delay);            // DELAY: sample input
-              while( Time < NextTime )  {  // do continuous steps
+              while( SIMLIB_Time < SIMLIB_NextTime )  {  // do continuous steps
                                            // until scheduled event or end ...
                   IntegrationMethod::StepSim(); // *** continuous step ***
 
-                  SIMLIB_run_statistics.StepCount++; // some runtime statistics
-                  if(SIMLIB_run_statistics.MinStep<0) {
-                      SIMLIB_run_statistics.MinStep = StepSize;
-                      SIMLIB_run_statistics.MaxStep = StepSize;
-                  } else if(SIMLIB_run_statistics.MinStep>StepSize)
-                      SIMLIB_run_statistics.MinStep = StepSize;
-                  else if(SIMLIB_run_statistics.MaxStep<StepSize)
-                      SIMLIB_run_statistics.MaxStep = StepSize;
+                  SIMLIB_statistics.StepCount++; // some runtime statistics
+                  if(SIMLIB_statistics.MinStep<0) {
+                      SIMLIB_statistics.MinStep = SIMLIB_StepSize;
+                      SIMLIB_statistics.MaxStep = SIMLIB_StepSize;
+                  } else if(SIMLIB_statistics.MinStep>SIMLIB_StepSize)
+                      SIMLIB_statistics.MinStep = SIMLIB_StepSize;
+                  else if(SIMLIB_statistics.MaxStep<SIMLIB_StepSize)
+                      SIMLIB_statistics.MaxStep = SIMLIB_StepSize;
 
                   SIMLIB_DoConditions();   // perform state events
                   CALL_HOOK(Delay);        // DELAY: sample input at each step
                   CALL_HOOK(Break); // user can stop simulation by any key?
                                     // TODO: use signal handler, ^C=SIGINT
-                  if(StopFlag)
+                  if(SIMLIB_state.StopFlag)
                       break;        // end of simulation run was required
                                     // by a state-event
               } // while continuous steps
               // _SetTime( Time, NextTime ); // set next event activation time
               // ^^^^^^^^^^^^^^^^^^^^^^^^^^^ should be in StepSim()
           } else { // no integrators, status blocks, ...
-              _SetTime( Time, NextTime ); // set next event activation time
+              _SetTime( SIMLIB_Time, SIMLIB_NextTime ); // set next event activation time
           }
       } // if (NextTime>Time)
 
@@ -298,20 +266,21 @@ void Run() {
       if( endFlag )  break; // end of simulation if no event at endtime
       ///////////// (TODO: ###BUG? state-conditions can schedule!)
 
-      while( Time >= NextTime && !StopFlag && !SQS::Empty() ) {
+      while( SIMLIB_Time >= SIMLIB_NextTime && !SIMLIB_state.StopFlag && !SQS::Empty() ) {
           // there are events scheduled at current Time
           // >= because of rounding errors
           SIMLIB_Current = SQS::GetFirst(); // get first record from calendar
           SIMLIB_DoActions();  // perform actions (see waitunti.cc)
-          SIMLIB_run_statistics.EventCount++;   // internal statistics
-          // assert: SIMLIB_Current is NULL
+          SIMLIB_statistics.EventCount++;   // internal statistics
+          // assert: Current is NULL
           CALL_HOOK(Break); // Callback: user can stop simulation by key or GUI
         }
   } // main loop
   IntegrationMethod::IntegrationDone(); // terminate integration run
   SQS::Clear();                         // terminate all scheduled events/processes
-  SIMLIB_Phase = TERMINATION;
-  SIMLIB_run_statistics.EndTime = Time;
+  SIMLIB_ObjectPoolTrim();              // free memory of deleted objects
+  Phase = TERMINATION;
+  SIMLIB_statistics.EndTime = SIMLIB_Time;
   Dprintf(("\n\t ********** Run() --- END \n"));
 }
 
@@ -91,7 +91,7 @@ void Sampler::Behavior() {
   Dprintf(("Sampler::Behavior()"));
   Sample();                     // call of global function
   if( on && step > 0.0 )
-    Activate( Time + step );    // schedule next sample
+    Activate( SIMLIB_Time + step );    // schedule next sample
   else
     Passivate(); // should be passivated before ###????
 }
@@ -135,7 +135,7 @@ void Sampler::Start()
 void Sampler::Stop()
 {
   on=false;
-  if(last==Time) // was sample at this time
+  if(last==SIMLIB_Time) // was sample at this time
     Passivate();
   else
     Activate();
@@ -148,7 +148,7 @@ void Sampler::Sample()
 {
   if(function)
     function(); // call global function
-  last = Time;
+  last = SIMLIB_Time;
 }
 
 ////////////////////////////////////////////////////////////////////////////
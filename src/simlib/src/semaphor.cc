@@ -79,9 +79,9 @@ void Semaphore::P()
   Dprintf(("Semaphore'%s'.P()", Name().c_str()));
 
   while(n == 0) {
-    Q.Insert(Current);  // Current==this
-    Passivate(Current);
-    Q.Get(Current);
+    Q.Insert(SIMLIB_Current);  // Current==this
+    Passivate(SIMLIB_Current);
+    Q.Get(SIMLIB_Current);
   }
   n--;
 }
@@ -49,6 +49,7 @@
 
 ////////////////////////////////////////////////////////////////////////////
 // includes
+#include <cstdint>      // uint64_t
 #include <cstdlib>      // size_t
 #include <list>         // std::list<>
 #include <string>       // std::string
@@ -106,6 +107,7 @@ static unsigned long SIMLIB_old_debug_flags = Debug(SIMLIB_DEBUG);
 //
 
 class SimObject;                // base abstract class
+class OutputFormatter;          // structured output of objects
 // discrete:
 class   Link;                   // list item base class (Simula-like)
 class     Entity;               // discrete model entity
@@ -147,30 +149,65 @@ class        ConditionDown;     // action by TRUE-->FALSE
 const double SIMLIB_MINTIME = 0.0;    //!< minimal time value
 const double SIMLIB_MAXTIME = 1.0e30; //!< maximum time (1e30 works for float, too)
 
+////////////////////////////////////////////////////////////////////////////
+// thread-local storage of SIMLIB variables
+// all of them are constant-initialized: GNU __thread avoids the call
+// of thread_local init wrapper at each access from other modules
+#if defined(__GNUC__)
+#define SIMLIB_THREAD_LOCAL __thread
+#else
+#define SIMLIB_THREAD_LOCAL thread_local
+#endif
+
 ////////////////////////////////////////////////////////////////////////////
 // CATEGORY: global variables
-// Warning: NOT THREAD-SAFE! --- TODO: change to methods of SimulationContext
+// Read-only references, bound in each thread to its own variables
+// (see SimulationContext) --- set by simulator only (Init, SetStep, ...)
 
-extern Entity *const &Current;    //!< pointer to active (now running) entity
+extern thread_local Entity *const & Current; //!< pointer to active (now running) entity
 
 // time values:
-extern const double & StartTime;       //!< time of simulation start
-extern const double & NextTime;        //!< next-event time
-extern const double & EndTime;         //!< time of simulation end
+extern thread_local const double & StartTime;  //!< time of simulation start
+extern thread_local const double & NextTime;   //!< next-event time
+extern thread_local const double & EndTime;    //!< time of simulation end
 
 // WARNING: Time cannot be used in block expressions!
-extern const double & Time;            //!< model time (is NOT the block)
-extern aContiBlock  & T;               //!< model time (continuous block)
+extern thread_local const double & Time;       //!< model time (is NOT the block)
+extern aContiBlock  & T;                //!< model time (continuous block)
 
 // read-only step limits of numerical integration method
-extern const double &MinStep;     //!< minimal step size
-extern const double &StepSize;    //!< current step size
-extern const double &OptStep;     //!< optimal step size
-extern const double &MaxStep;     //!< maximal step size
+extern thread_local const double & MinStep;    //!< minimal step size
+extern thread_local const double & StepSize;   //!< current step size
+extern thread_local const double & OptStep;    //!< optimal step size
+extern thread_local const double & MaxStep;    //!< maximal step size
 
 // error params for numerical integration methods
-extern const double &AbsoluteError; //!< max absolute error
-extern const double &RelativeError; //!< max relative error
+extern thread_local const double & AbsoluteError; //!< max absolute error
+extern thread_local const double & RelativeError; //!< max relative error
+
+////////////////////////////////////////////////////////////////////////////
+//! Independent simulation experiment state: model time, calendar, random
+//! generator, WaitUntil list, ... Each thread starts in its own default
+//! context, so independent simulations can run in parallel threads.
+//! More contexts can be used alternately in single thread (Select).
+//! <br> Model objects belong to the context active at their creation.
+//! Memory pools are per thread: use and destroy the context in one thread.
+//! <br> The continuous part of SIMLIB (integrators, conditions, Sampler,
+//! Delay, ...) is shared by all contexts: only one can use it.
+class SimulationContext {
+    struct Data;                        // saved state of inactive context
+    Data *data;
+    static SIMLIB_THREAD_LOCAL SimulationContext *active;
+    static SIMLIB_THREAD_LOCAL Data *default_data;
+    SimulationContext(const SimulationContext&) = delete;
+    SimulationContext &operator=(const SimulationContext&) = delete;
+  public:
+    SimulationContext();                //!< state of program start
+    ~SimulationContext();               //!< destroys scheduled entities
+    void Select();                      //!< activate in current thread
+    static void SelectDefault();        //!< back to default context of thread
+    static SimulationContext *Active(); //!< active context (0 = default)
+};
 
 ////////////////////////////////////////////////////////////////////////////
 // CATEGORY: global functions ...
@@ -184,8 +221,12 @@ inline void Init(double t0, double t1=SIMLIB_MAXTIME) {
 }
 
 //! Set calendar implementation.
-//! @param name String identification of calendar: "list", "cq"
+//! @param name String identification of calendar: "list", "cq", "heap", "ladder"
 void SetCalendar(const char *name);
+//! Get name of available calendar implementation (for benchmarks).
+//! @param i index of implementation
+//! @returns name usable in SetCalendar, 0 if i is out of range
+const char *CalendarName(unsigned i);
 
 //! Set integration step interval.
 //! @param dtmin  min. step size
@@ -258,8 +299,54 @@ double Random();
 //! default Random() implementation can be replaced
 //! @param new_gen pointer to user-defined function
 void   SetBaseRandomGenerator(double (*new_gen)());
+//! initialize random number seed for replication of experiment
+//! @param seed initial value of generator state
+//! @param replication RandomStream generators start at independent states
+void   RandomSeed(long seed, unsigned long replication);
+//! fill array by n numbers of Random()
+//! (faster than n calls for built-in base generators)
+void   RandomFill(double *p, std::size_t n);
+//! xoshiro256++ base generator (RandomStream selected by SetRandomStream())
+//! use SetBaseRandomGenerator(RandomXoshiro256) to replace the LCG
+double RandomXoshiro256();
+
+////////////////////////////////////////////////////////////////////////////
+//! Independent stream of pseudorandom numbers (xoshiro256++, period 2^256-1)
+//!
+//! The stream is seeded by RandomSeed() (at its first use after the call):
+//! the state is derived from the seed and the name of stream by SplitMix64,
+//! so streams with different names are independent (arrivals, service, ...).
+//! In replication r (see RandomSeed(seed,r)) the state is the r-th block of
+//! the SplitMix64 sequence (O(1) for any r): m replications drawing n numbers
+//! overlap with probability about m*m*n/2^256. Jump() and LongJump() give
+//! provably disjoint parts of one stream.
+//! <br> The stream belongs to the SimulationContext active at its first use.
+class RandomStream {
+    uint64_t s[4];              // generator state
+    uint64_t key;               // hash of the name (0 = default stream)
+    unsigned long epoch;        // RandomSeed() number of last seeding
+    void Reseed();
+  public:
+    constexpr RandomStream() : s{0,0,0,0}, key(0), epoch(0) {}
+    explicit RandomStream(const char *name);
+    //! explicit seeding (until next RandomSeed() call)
+    void Seed(unsigned long seed, unsigned long replication=0);
+    uint64_t Next64();                      //!< 64 random bits
+    double operator()();                    //!< uniform 0 .. 0.999999...
+    void Fill(double *p, std::size_t n);    //!< n uniform numbers
+    void Jump();                            //!< skip 2^128 numbers
+    void LongJump();                        //!< skip 2^192 numbers
+};
+//! select the stream of RandomXoshiro256() --- with it as base generator,
+//! Random() and all distributions draw from s (0 = default stream)
+//! @returns previously selected stream
+RandomStream *SetRandomStream(RandomStream *s);
 
 // following generators depend on Random()
+//! Normal() and Exponential() use the methods of SIMLIB 3.09 (sum of 12
+//! Random() numbers, inversion by log), the default is ziggurat method
+//! @param on reproduce results of older versions
+void   SetRandomCompatibility(bool on);
 //! Beta distribution generator @param th @param fi @param min @param max
 double Beta(double th, double fi, double min, double max);
 //! Erlang distribution generator @param alfa @param beta
@@ -279,6 +366,12 @@ int    NegBin(double q, int k);
 double Normal(double mi, double sigma);
 //! Poisson distribution generator @param lambda
 int    Poisson(double lambda);
+//! fill array by n numbers of Poisson(lambda) @param lambda
+void   PoissonFill(double lambda, int *p, std::size_t n);
+//! Binomial distribution generator @param n number of trials @param p probability
+int    Binom(int n, double p);
+//! fill array by count numbers of Binom(n,p) @param n @param p
+void   BinomFill(int n, double p, int *a, std::size_t count);
 double Rayle(double delta);
 double Triag(double mod, double min, double max);
 //! Uniform distribution generator @param l low limit @param h high limit
@@ -302,7 +395,8 @@ class SimObject {
         _CLEAR_ALL_FLAGS = 0,
         _ALLOCATED_FLAG  = 1<<0,        // object is on heap
         _EVAL_FLAG       = 1<<1,        // currently evaluated (aBlock)
-        _HAS_NAME_FLAG   = 1<<2         // object has name (in dictionary)
+        _HAS_NAME_FLAG   = 1<<2,        // object has name (in dictionary)
+        _REPORT_FLAG     = 1<<3         // object is in OutputStatistics() list
   };
  protected:
   unsigned _flags;      //!< bool flags for internal use (TODO bitfield?)
@@ -311,7 +405,7 @@ class SimObject {
   SimObject();
   virtual ~SimObject();
   void *operator new(size_t size);     //!< allocate object, set _flags
-  void operator delete(void *ptr);     //!< deallocate object
+  void operator delete(void *ptr, size_t size); //!< deallocate object
   void *operator new[](size_t size) = delete;
   void operator delete[](void *ptr) = delete;
 // TODO: FIXME inconsistent name:
@@ -323,11 +417,60 @@ class SimObject {
 
   // TODO: define friend operator <<
   virtual void Output() const;         //!< print object to default output
+  //! structured output (key of nested object, nullptr at top level)
+  virtual void Report(OutputFormatter &f, const char *key=nullptr) const;
  private:
   SimObject(const SimObject &) = delete;                //!< disable copy operation
   SimObject &operator= (const SimObject &) = delete;    //!< disable assign operation
 };
 
+//! statistics of SimObject memory pool (single size class)
+struct SimObjectPoolStat {
+  size_t size;            //!< block size (0 for large objects)
+  unsigned long live;     //!< objects in use
+  unsigned long allocs;   //!< number of allocations
+  unsigned long chunks;   //!< memory chunks held by class
+};
+unsigned SimObjectPoolClasses(); //!< number of size classes (incl. large)
+bool SimObjectPoolStatistics(unsigned c, SimObjectPoolStat &st); //!< class c
+
+////////////////////////////////////////////////////////////////////////////
+//! structured (machine-readable) output of objects
+//! Report() methods describe an object as a tree of named fields, the
+//! formatter appends it to a buffer in its format. Formats: "json" (one
+//! JSON document per report and line), "binary" (tagged records, exact
+//! values, see report.cc)
+//! \ingroup simlib
+class OutputFormatter {
+ public:
+  virtual ~OutputFormatter() {}
+  virtual void Begin(double time) = 0;  //!< start of report at model time
+  //! start of object, key is nullptr for top level objects
+  virtual void BeginObject(const char *key, const char *type, const std::string &name) = 0;
+  virtual void Field(const char *key, double x) = 0;
+  virtual void Field(const char *key, unsigned long x) = 0;
+  virtual void Field(const char *key, const std::string &s) = 0;
+  virtual void Array(const char *key, const unsigned long *a, unsigned n) = 0;
+  virtual void EndObject() = 0;
+  virtual void End() = 0;               //!< end of report
+  const std::string &Data() const { return data; }  //!< formatted report
+  void Reset() { data.clear(); }
+ protected:
+  std::string data;
+};
+//! formatter of given format ("json", "binary"), nullptr if unknown
+OutputFormatter *CreateOutputFormatter(const char *format);
+//! format of OutputStatistics(): "text" (Output(), default), "json", "binary"
+void SetOutputFormat(const char *format);
+//! add object to the list of OutputStatistics() (until its destruction)
+void OutputRegister(SimObject &o);
+//! remove object from the list of OutputStatistics()
+void OutputUnregister(SimObject &o);
+//! output all registered objects in one pass in the current format
+void OutputStatistics();
+//! report of all registered objects in given format (e.g. for replications)
+std::string ReportStatistics(const char *format);
+
 ////////////////////////////////////////////////////////////////////////////
 //! base class for all double-linked list items
 //! <br> item can be at single place only (identified by where() method)
@@ -374,7 +517,7 @@ struct EventNotice;     // we use only pointer to this class here
 //! \ingroup simlib
 class Entity : public Link {
   protected:
-    static unsigned long _Number;   //!< current number of entities
+    static SIMLIB_THREAD_LOCAL unsigned long _Number; //!< current number of entities
     unsigned long _Ident;           //!< unique identification number of entity
     ////////////////////////////////////////////////////////////////////////////
     // TODO: next attributes will be changed/removed:
@@ -440,6 +583,7 @@ inline void Passivate(Entity *e) { e->Passivate(); }  //!< passivate entity e
 class Process : public Entity {
   void * _context;                      //!< process context pointer
   virtual void _Run() noexcept override;        // internal point of activation
+  void _RunCopy() noexcept;             // _Run() with stack copying
 
   //! possible process status values
   enum ProcessStatus_t {
@@ -559,11 +703,14 @@ class aStat : public SimObject {
 
 ////////////////////////////////////////////////////////////////////////////
 //! class for statistical information gathering
+//! mean and variance are updated by Welford's method (no cancellation
+//! for large n or large mean), statistics of parts (threads, replications)
+//! can be merged (Chan et al.) or moved as a binary image (Serialize)
 //! \ingroup simlib
 class Stat : public SimObject {
  protected:
-  double sx;                    // sum of values
-  double sx2;                   // sum of value square
+  double mean;                  // mean value
+  double m2;                    // sum of squared deviations from mean
   double min;                   // min value
   double max;                   // max value
   unsigned long n;              // number of values recorded
@@ -573,14 +720,16 @@ class Stat : public SimObject {
   ~Stat();
   virtual void Clear();         //!< initialize
   void operator () (double x);  //!< record the value
-// Stat &operator = (Stat &x);  // TODO: copy semantics
-// Stat &operator += (Stat &x); // sum two statistics + template operator +
+  void Merge(const Stat &s);    //!< add values recorded in s
+  std::string Serialize() const;               //!< binary image (without name)
+  void Deserialize(const std::string &image);  //!< restore from Serialize()
   virtual void Output() const override;  //!< print statistics
+  virtual void Report(OutputFormatter &f, const char *key=nullptr) const override;
   unsigned long Number() const { return n; }
   double Min() const           { /* TODO: test n==0 */ return min; }
   double Max() const           { /* test n==0 */ return max; }
-  double Sum() const           { return sx; }
-  double SumSquare() const     { return sx2; }
+  double Sum() const           { return mean*n; }
+  double SumSquare() const     { return m2 + mean*mean*n; }
   double MeanValue() const;
   double StdDev() const;
 };
@@ -588,11 +737,14 @@ class Stat : public SimObject {
 
 ////////////////////////////////////////////////////////////////////////////
 //! time dependent statistic
+//! time-weighted mean and variance are updated by weighted Welford's
+//! method, statistics can be merged and serialized as Stat
 //! \ingroup simlib
 class TStat : public SimObject {
  protected:
-  double sxt;                   // sum of x*time
-  double sx2t;                  // sum of squares
+  double tw;                    // total time of closed periods (tl-t0 if not merged)
+  double mean;                  // time-weighted mean of closed periods
+  double m2;                    // time-weighted sum of squared deviations
   double min;                   // min value x
   double max;                   // max value x
   double t0;                    // time of initialization
@@ -608,16 +760,23 @@ class TStat : public SimObject {
   ~TStat();
   virtual void Clear(double initval=0.0);        //!< initialize
   virtual void Output() const override;          //!< print object to default output
+  virtual void Report(OutputFormatter &f, const char *key=nullptr) const override;
   virtual void operator () (double x);           //!< record the value
+  void Merge(const TStat &s);   //!< add s, its last value counts up to Time
+  std::string Serialize() const;               //!< binary image (without name)
+  void Deserialize(const std::string &image);  //!< restore from Serialize()
   unsigned long Number() const { return n; }
   double Min() const           { /*TODO: only if(n>0)*/ return min; }
   double Max() const           { return max; }
-  double Sum() const           { return sxt; }
-  double SumSquare() const     { return sx2t; }
+  double Sum() const           { return mean*tw; }
+  double SumSquare() const     { return m2 + mean*mean*tw; }
   double StartTime() const     { return t0; }
   double LastTime() const      { return tl; }
   double LastValue() const     { return xl; }
   double MeanValue() const;
+  double StdDev() const;        //!< time-weighted standard deviation
+ private:
+  void Current(double &w, double &m, double &s) const;  // including last period
 };
 
 
@@ -695,6 +854,7 @@ class Queue : public List { // don't inherit interface for now
     ~Queue();                           // list destructor clears content
     //virtual const char *Name() const;
     virtual void Output() const override;         //!< print statistics
+    virtual void Report(OutputFormatter &f, const char *key=nullptr) const override;
     operator Queue* () { return this; }  // allows Queue instead Queue*
     iterator begin()   { return List::begin(); }
     iterator end()     { return List::end(); }
@@ -734,6 +894,7 @@ class Histogram : public SimObject {
   Histogram(const char *_name, double low, double step, unsigned count=10);
   ~Histogram();
   virtual void Output() const override;         //!< print to default output
+  virtual void Report(OutputFormatter &f, const char *key=nullptr) const override;
   void Init(double low, double step, unsigned count);
   void operator () (double x);         // record value x
   virtual void Clear();                // initialize (zero) value array
@@ -744,6 +905,49 @@ class Histogram : public SimObject {
   unsigned operator [](unsigned i) const;  // # of items in interval[i]
 };
 
+////////////////////////////////////////////////////////////////////////////
+//! log-linear histogram for quantiles (HDR-like)
+//! each power of two in [low, high) is divided into 2^bits equal buckets,
+//! so Quantile() has relative error at most RelativeError() = 2^-(bits+1);
+//! values below low and above high go to two extra buckets (no bound there).
+//! Recording is O(1) without allocation, histograms with the same layout
+//! can be merged (e.g. per-replication histograms)
+//! \ingroup simlib
+class QuantileHistogram : public SimObject {
+ protected:
+  unsigned long *dptr;       // counts: [0] < low, [1..buckets] log-linear, [buckets+1] >= high
+  double   low;              // low bound of the log-linear range
+  double   scale;            // 1/low
+  unsigned bits;             // log2 of buckets per power of two
+  unsigned octaves;          // powers of two in the range (high = low*2^octaves)
+  unsigned long n;           // number of values recorded
+  double   sx;               // sum of values
+  double   min;              // min value
+  double   max;              // max value
+  double   BucketLow(unsigned i) const;  // low bound of log-linear bucket i
+ public:
+  QuantileHistogram(double low=1e-6, double high=1e3, unsigned bits=7);
+  QuantileHistogram(const char *_name, double low, double high, unsigned bits=7);
+  ~QuantileHistogram();
+  virtual void Output() const override;         //!< print to default output
+  virtual void Report(OutputFormatter &f, const char *key=nullptr) const override;
+  void Init(double low, double high, unsigned bits);
+  void operator () (double x);         //!< record value x
+  virtual void Clear();                //!< initialize (zero) counts
+  void Merge(const QuantileHistogram &h);  //!< add counts of h (same layout)
+  double Quantile(double p) const;     //!< estimate of p-quantile, p in 0..1
+  double RelativeError() const { return 1.0 / (2 << bits); }
+  double Low() const     { return low; }
+  double High() const    { return BucketLow(Buckets()); }
+  unsigned Bits() const  { return bits; }
+  unsigned Buckets() const { return octaves << bits; }
+  unsigned long Number() const { return n; }
+  double Min() const     { return min; }
+  double Max() const     { return max; }
+  double Sum() const     { return sx; }
+  double MeanValue() const;
+};
+
 
 
 ////////////////////////////////////////////////////////////////////////////
@@ -764,6 +968,7 @@ class Facility : public SimObject {
   Facility(const char *_name, Queue *_queue1);
   virtual ~Facility();
   virtual void Output() const override;                   //!< print statistics
+  virtual void Report(OutputFormatter &f, const char *key=nullptr) const override;
   operator Facility* () { return this; }
   void SetQueue(Queue *queue1);                 //!< change input queue
   bool OwnQueue() const;                        //!< test for default queue
@@ -797,6 +1002,7 @@ class Store : public SimObject {
   Store(const char *_name, unsigned long _capacity, Queue *queue);
   virtual ~Store();
   virtual void Output() const override;                 //!< print statistics
+  virtual void Report(OutputFormatter &f, const char *key=nullptr) const override;
   operator Store* () { return this; }
   void SetCapacity(unsigned long _capacity);            //!< change the capacity
   void SetQueue(Queue *queue);                          //!< change input queue
@@ -1805,16 +2011,25 @@ struct SIMLIB_statistics_t {
   long   StepCount;     // for continuous simulation
   double MinStep;
   double MaxStep;
-  //! constructor runs SIMLIB_statistics_t::Init()
-  SIMLIB_statistics_t();
+  // calendar activation records (EventNotice slab allocator):
+  long   EventNoticeAllocs;      // allocations in this run
+  long   EventNoticeLive;        // records in use
+  long   EventNoticeMaxLive;     // max. records in use in this run
+  long   EventNoticeChunks;      // chunks allocated
+  long   EventNoticeChunksFreed; // chunks returned to system in this run
+  //! constructor: the same values as SIMLIB_statistics_t::Init()
+  constexpr SIMLIB_statistics_t() :
+    StartTime(-1), EndTime(-1), EventCount(0), StepCount(0),
+    MinStep(-1), MaxStep(-1), EventNoticeAllocs(0), EventNoticeLive(0),
+    EventNoticeMaxLive(0), EventNoticeChunks(0), EventNoticeChunksFreed(0) {}
   //! initialize - used at the start of each Run()
   void Init();
   //! print run-time statistics to output
   void Output() const;
 };
 
-//! interface to internal run-time statistics structure
-extern const SIMLIB_statistics_t & SIMLIB_statistics;
+//! internal run-time statistics structure (read-only, one per thread)
+extern SIMLIB_THREAD_LOCAL SIMLIB_statistics_t SIMLIB_statistics;
 
 } // namespace simlib3
 
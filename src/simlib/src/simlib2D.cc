@@ -123,7 +123,7 @@ void aContiBlock2D::_Eval()
 // Parameter2D --- parameter of model
 //
 Parameter2D &Parameter2D::operator= (const Value2D &x)    {
-  if(SIMLIB_Phase==SIMULATION)
+  if(Phase==SIMULATION)
     SIMLIB_error(ParameterChangeErr);
   value = x;
   return *this;
@@ -121,7 +121,7 @@ void aContiBlock3D::_Eval()
 // Parameter3D --- parameter of model
 //
 Parameter3D &Parameter3D::operator= (const Value3D &x)    {
-  if(SIMLIB_Phase==SIMULATION)
+  if(Phase==SIMULATION)
     SIMLIB_error(ParameterChangeErr);
   value = x;
   return  *this;
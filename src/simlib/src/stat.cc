@@ -18,6 +18,7 @@
 #include "internal.h"
 
 #include <cmath>     // sqrt()
+#include <cstring>   // memcpy(), memcmp()
 
 
 ////////////////////////////////////////////////////////////////////////////
@@ -29,25 +30,79 @@ namespace simlib3 {
 SIMLIB_IMPLEMENTATION;
 
 ////////////////////////////////////////////////////////////////////////////
-//  operator ()  --- record value
+//  operator ()  --- record value (Welford)
 //
 void Stat::operator () (double x)
 {
-  sx  += x;
-  sx2 += x*x;
-  if(++n==1) min=max=x;
+  double d = x - mean;
+  n++;
+  mean += d/n;
+  m2 += d*(x - mean);
+  if(n==1) min=max=x;
   else {
     if(x<min) min = x;
     if(x>max) max = x;
   }
 };
 
+////////////////////////////////////////////////////////////////////////////
+//  Merge --- add values of other statistics (Chan et al.)
+//
+void Stat::Merge(const Stat &s)
+{
+  if (s.n==0) return;
+  if (n==0) {
+    mean = s.mean; m2 = s.m2;
+    min = s.min;   max = s.max;
+    n = s.n;
+    return;
+  }
+  double na = n, nb = s.n, d = s.mean - mean;
+  n += s.n;
+  mean += d*nb/n;
+  m2 += s.m2 + d*d*na*nb/n;
+  if (s.min<min) min = s.min;
+  if (s.max>max) max = s.max;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  binary image --- native byte order, for exchange between threads or
+//  processes on one machine
+//
+struct StatImage {
+  char tag[8];
+  uint64_t n;
+  double mean, m2, min, max;
+};
+static const char StatTag[8] = { 'S','I','M','L','S','T','1',0 };
+
+std::string Stat::Serialize() const
+{
+  StatImage im;
+  memcpy(im.tag, StatTag, sizeof(im.tag));
+  im.n = n;
+  im.mean = mean; im.m2 = m2;
+  im.min = min;   im.max = max;
+  return std::string(reinterpret_cast<const char*>(&im), sizeof(im));
+}
+
+void Stat::Deserialize(const std::string &image)
+{
+  StatImage im;
+  if (image.size() != sizeof(im)) SIMLIB_error(StatImageError);
+  memcpy(&im, image.data(), sizeof(im));
+  if (memcmp(im.tag, StatTag, sizeof(im.tag)) != 0) SIMLIB_error(StatImageError);
+  n = im.n;
+  mean = im.mean; m2 = im.m2;
+  min = im.min;   max = im.max;
+}
+
 
 ////////////////////////////////////////////////////////////////////////////
 //  constructors
 //
 Stat::Stat(const char *name) :
-  sx(0), sx2(0),
+  mean(0), m2(0),
   min(0), max(0),
   n(0)
 {
@@ -56,7 +111,7 @@ Stat::Stat(const char *name) :
 }
 
 Stat::Stat() :
-  sx(0), sx2(0),
+  mean(0), m2(0),
   min(0), max(0),
   n(0)
 {
@@ -76,7 +131,7 @@ Stat::~Stat()
 //
 void Stat::Clear()
 {
-  sx = sx2 = 0;    // sums
+  mean = m2 = 0;   // moments
   min = max = 0;
   n = 0;           // # of records
 }
@@ -88,7 +143,7 @@ void Stat::Clear()
 double Stat::MeanValue() const
 {
   if (n==0) SIMLIB_error(StatNoRecError);
-  return sx/n;
+  return mean;
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -97,8 +152,7 @@ double Stat::MeanValue() const
 double Stat::StdDev() const
 {
   if (n<2)  SIMLIB_error(StatDispError);
-  double mv = sx/n;
-  return sqrt((sx2-n*mv*mv)/(n-1));
+  return sqrt(m2/(n-1));
 }
 
 }
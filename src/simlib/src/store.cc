@@ -130,7 +130,7 @@ void Store::Enter(Entity *e, unsigned long rcap)
 // TODO: remove parameter e, use Current
   Dprintf(("%s.Enter(%s,%lu)",Name().c_str(),e->Name().c_str(),rcap));
 
-  if (e != Current)
+  if (e != SIMLIB_Current)
     SIMLIB_error(EntityRefError); // current process only
 
   if (rcap>capacity)  SIMLIB_error(EnterCapError);
@@ -17,6 +17,9 @@
 #include "simlib.h"
 #include "internal.h"
 
+#include <cmath>     // sqrt()
+#include <cstring>   // memcpy(), memcmp()
+
 ////////////////////////////////////////////////////////////////////////////
 // implementation
 //
@@ -30,9 +33,9 @@ SIMLIB_IMPLEMENTATION;
 //  constructors
 //
 TStat::TStat(double initval):
-  sxt(0), sx2t(0),
+  tw(0), mean(0), m2(0),
   min(initval), max(initval),
-  t0(Time), tl(Time),     // time of initialization and last op
+  t0(SIMLIB_Time), tl(SIMLIB_Time),     // time of initialization and last op
   xl(initval),            // last value
   n(0UL)                  // number of records
 {
@@ -40,9 +43,9 @@ TStat::TStat(double initval):
 }
 
 TStat::TStat(const char *name, double initval) :
-  sxt(0), sx2t(0),
+  tw(0), mean(0), m2(0),
   min(initval), max(initval),
-  t0(Time), tl(Time),
+  t0(SIMLIB_Time), tl(SIMLIB_Time),
   xl(initval),
   n(0UL)
 {
@@ -63,12 +66,16 @@ TStat::~TStat()
 //
 void TStat::operator () (double x)
 {
-  if (Time<tl) SIMLIB_warning(TStatNotInitialized);
-  double tt = xl*(double(Time)-tl);
-  sxt  += tt;
-  sx2t += xl*tt;
+  if (SIMLIB_Time<tl) SIMLIB_warning(TStatNotInitialized);
+  double w = double(SIMLIB_Time)-tl;          // duration of last value xl
+  if (w > 0) {                         // weighted Welford
+    tw += w;
+    double d = xl - mean;
+    mean += d*w/tw;
+    m2 += w*d*(xl - mean);
+  }
   xl = x;
-  tl = Time;
+  tl = SIMLIB_Time;
   if(++n==1) min=max=x;   // TODO: check
   else
   {
@@ -83,24 +90,107 @@ void TStat::operator () (double x)
 void TStat::Clear(double initval)
 {
   Dprintf(("TStat::Clear() // \"%s\" ", Name().c_str()));
-  sxt = sx2t = 0;
+  tw = mean = m2 = 0;
   min = max = initval;
-  t0 = tl = Time;
+  t0 = tl = SIMLIB_Time;
   xl = initval;       // last value
   n = 0UL;
 }
 
+////////////////////////////////////////////////////////////////////////////
+//  TStat::Current --- total time, mean and m2 including last period
+//  (last value xl from tl to Time)
+//
+void TStat::Current(double &w, double &m, double &s) const
+{
+  double wl = double(SIMLIB_Time)-tl;
+  w = tw; m = mean; s = m2;
+  if (wl > 0) {
+    w += wl;
+    double d = xl - m;
+    m += d*wl/w;
+    s += wl*d*(xl - m);
+  }
+}
+
 ////////////////////////////////////////////////////////////////////////////
 //  TStat::MeanValue
 //
 double TStat::MeanValue() const
 {
 //  if(n==0)     Error(111); // FIXME: error message
-  if(Time<t0)
+  if(SIMLIB_Time<t0)
     SIMLIB_error(TStatNotInitialized);;
-  if(Time==t0)  return xl;
-  double sumxt = sxt + xl*(double(Time)-tl); // count last period
-  return sumxt/(double(Time)-t0);
+  double w, m, s;
+  Current(w, m, s);
+  if(w==0)  return xl;
+  return m;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  TStat::StdDev --- time-weighted standard deviation
+//
+double TStat::StdDev() const
+{
+  if(SIMLIB_Time<t0)
+    SIMLIB_error(TStatNotInitialized);
+  double w, m, s;
+  Current(w, m, s);
+  if(w==0)  return 0;
+  return sqrt(s/w);
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  TStat::Merge --- add other statistics (e.g. replication), its last
+//  value counts up to Time (as in its MeanValue())
+//
+void TStat::Merge(const TStat &s)
+{
+  double wb, mb, sb;
+  s.Current(wb, mb, sb);
+  if (wb > 0) {
+    double wa = tw, d = mb - mean;
+    tw += wb;
+    mean += d*wb/tw;
+    m2 += sb + d*d*wa*wb/tw;
+  }
+  n += s.n;
+  if (s.min<min) min = s.min;
+  if (s.max>max) max = s.max;
+  if (s.t0<t0) t0 = s.t0;
+}
+
+////////////////////////////////////////////////////////////////////////////
+//  binary image --- native byte order (see Stat::Serialize)
+//
+struct TStatImage {
+  char tag[8];
+  uint64_t n;
+  double t0, tl, xl, tw, mean, m2, min, max;
+};
+static const char TStatTag[8] = { 'S','I','M','L','T','S','1',0 };
+
+std::string TStat::Serialize() const
+{
+  TStatImage im;
+  memcpy(im.tag, TStatTag, sizeof(im.tag));
+  im.n = n;
+  im.t0 = t0;     im.tl = tl;     im.xl = xl;
+  im.tw = tw;     im.mean = mean; im.m2 = m2;
+  im.min = min;   im.max = max;
+  return std::string(reinterpret_cast<const char*>(&im), sizeof(im));
+}
+
+void TStat::Deserialize(const std::string &image)
+{
+  TStatImage im;
+  if (image.size() != sizeof(im)) SIMLIB_error(StatImageError);
+  memcpy(&im, image.data(), sizeof(im));
+  if (memcmp(im.tag, TStatTag, sizeof(im.tag)) != 0) SIMLIB_error(StatImageError);
+  n = im.n;
+  t0 = im.t0;     tl = im.tl;     xl = im.xl;
+  tw = im.tw;     mean = im.mean; m2 = im.m2;
+  min = im.min;   max = im.max;
 }
 
 }
@@ -31,41 +31,40 @@ namespace simlib3 {
 SIMLIB_IMPLEMENTATION;
 
 ////////////////////////////////////////////////////////////////////////////
-// class WaitUntilList --- singleton
+// class WaitUntilList --- singleton (one per SimulationContext)
 //
 class WaitUntilList {
     typedef std::list<Process *> container_t;
     container_t l;
-    static WaitUntilList *instance;   // unique list
   public:
     typedef container_t::iterator iterator;
-    static iterator begin() { return instance->l.begin(); }
-    static iterator end() { return instance->l.end(); }
-    static bool empty() { return instance->l.empty(); }
+    static iterator begin() { return SIMLIB_state.wulist->l.begin(); }
+    static iterator end() { return SIMLIB_state.wulist->l.end(); }
+    static bool empty() { return SIMLIB_state.wulist->l.empty(); }
     static void InsertCurrent();     // insert current process into list
     static void GetCurrent();        // get current process
     static void WU_hook(); // active: next process in WUlist or 0
     static void Remove(Process *p) { // find and remove p
         Dprintf(("WaitUntil::Remove(Process#%ld)", p->id()));
-        instance->l.remove(p); // should be in list
+        SIMLIB_state.wulist->l.remove(p); // should be in list
     }
     static void clear();    // empty
     static void create() {  // create single instance
-        if(instance==0) instance = new WaitUntilList;
+        if(SIMLIB_state.wulist==0) SIMLIB_state.wulist = new WaitUntilList;
         else            SIMLIB_internal_error(); // called twice
         INSTALL_HOOK(WUclear, WaitUntilList::clear);
         SIMLIB_atexit(destroy); // last SIMLIB module cleanup calls this
     }
     static void destroy() {  // destroy single instance
         clear();             // remove all contents
-        delete instance;
-        instance = 0;
+        delete SIMLIB_state.wulist;
+        SIMLIB_state.wulist = 0;
     }
   private:
-    WaitUntilList() { Dprintf(("WaitUntilList::WaitUntilList()")); }
+    WaitUntilList() : flag(false) { Dprintf(("WaitUntilList::WaitUntilList()")); }
     ~WaitUntilList() { Dprintf(("WaitUntilList::~WaitUntilList()")); }
-    // destructor never called ###???
-    static iterator current;
+    iterator current;   // processed item
+    bool flag;          // valid iterator in WUList
 #ifndef NDEBUG
     friend void WU_print();
 #endif
@@ -74,19 +73,20 @@ class WaitUntilList {
 #ifndef NDEBUG
     void WU_print() {
        _Print("WaitUntilList:\n");
-       if(WaitUntilList::instance == 0) { _Print("none\n"); return; }
+       if(SIMLIB_state.wulist == 0) { _Print("none\n"); return; }
        WaitUntilList::iterator i = WaitUntilList::begin();
        for( int n=0 ; i!=WaitUntilList::end() ; ++i, ++n )
          _Print(" [%d] Process#%ld\n", n, (*i)->id() );
     }
 #endif
 
-// WaitUntilList single instance
-WaitUntilList *WaitUntilList::instance = 0; // static
-WaitUntilList::iterator WaitUntilList::current; // static
-
 ////////////////////////////////////////////////////////////////////////////
-static bool flag = false; // valid iterator in WUList
+// destroy WaitUntilList of the active context (used by SimulationContext)
+void SIMLIB_WUDelete() {
+    if(SIMLIB_state.wulist)
+        WaitUntilList::destroy();
+}
+
 ////////////////////////////////////////////////////////////////////////////
 // main WUlist interface function
 void WaitUntilList::WU_hook() { // get ptr to next process in WUlist or 0
@@ -95,20 +95,21 @@ void WaitUntilList::WU_hook() { // get ptr to next process in WUlist or 0
     if(WaitUntilList::empty()) // this should never happen
         SIMLIB_internal_error();
 
-    if(!flag) { // start processing, (first call or after remove)
-        current = WaitUntilList::begin(); // reset to first process
-        flag = true;
+    WaitUntilList *wu = SIMLIB_state.wulist;
+    if(!wu->flag) { // start processing, (first call or after remove)
+        wu->current = WaitUntilList::begin(); // reset to first process
+        wu->flag = true;
         // loop_count++;
         // if(loop_count>LIMIT) error("waituntil-loop");
-        SIMLIB_Current = *current;  // always OK
+        SIMLIB_Current = *wu->current;  // always OK
         return;
     }
-    ++current;  // next waiting process
-    if( current != WaitUntilList::end() ) { // not end
-        SIMLIB_Current = *current;
+    ++wu->current;  // next waiting process
+    if( wu->current != WaitUntilList::end() ) { // not end
+        SIMLIB_Current = *wu->current;
         return;
     }
-    flag = false; // no next process --- end of WaitUntil processing
+    wu->flag = false; // no next process --- end of WaitUntil processing
     // loop_count = 0;
     SIMLIB_Current = 0; // not needed ???###
     return;
@@ -152,19 +153,19 @@ void Process::_WaitUntilRemove() {
 //
 void WaitUntilList::InsertCurrent()
 {
-    if(flag) return; // is in WUlist
+    if(SIMLIB_state.wulist==0)
+        create(); // create singleton instance
+    if(SIMLIB_state.wulist->flag) return; // is in WUlist
     //CONDITION: current process is not in WUlist
     Process *e = static_cast<Process*>(SIMLIB_Current); // TODO: dynamic_cast ?
     Dprintf(("WaitUntilList.Insert(Process#%ld)", e->id()));
-    if(instance==0)
-        create(); // create singleton instance
     if(empty())   // it was empty (FIXME: why not at creation time?)
         INSTALL_HOOK(WUget_next, WaitUntilList::WU_hook); // install hook
     iterator pos;
     for( pos = begin(); // find place from beginning
          pos != end() && (*pos)->Priority >= e->Priority;  // higher first
          ++pos ) { /*empty*/ }
-    instance->l.insert(pos,e);  // insert at position
+    SIMLIB_state.wulist->l.insert(pos,e);  // insert at position
     //e->_wait_until = true; // mark process as inserted
 }
 
@@ -174,14 +175,15 @@ void WaitUntilList::InsertCurrent()
 //
 void WaitUntilList::GetCurrent()
 {
-  if(!flag) return; // process is not in WUlist
+  WaitUntilList *wu = SIMLIB_state.wulist;
+  if(wu==0 || !wu->flag) return; // process is not in WUlist
   //PRECONDITION: WUlist is initialized, not empty
-  Process *p = *current;
+  Process *p = *wu->current;
   Dprintf(("WaitUntilList.Get(); // \"Process#%ld\" ", p->id()));
-  instance->l.erase(current); // remove item pointed by iterator (fast)
+  wu->l.erase(wu->current); // remove item pointed by iterator (fast)
   if(empty())
     INSTALL_HOOK(WUget_next, 0); // uninstall hook if last item removed
-  flag = false;           // iterator invalid, start from beginning
+  wu->flag = false;       // iterator invalid, start from beginning
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -189,7 +191,7 @@ void WaitUntilList::GetCurrent()
 //
 void WaitUntilList::clear()
 {
-    if(instance==0) return;
+    if(SIMLIB_state.wulist==0) return;
     // remove all processes in WaitUntilList
     // we can do this, because all processes in list are passivated
     iterator i=begin();
@@ -199,7 +201,7 @@ void WaitUntilList::clear()
        p->_WaitUntilRemove();        // unmark and remove process
        if( p->isAllocated() ) delete p; // the same behavior as Calendar###???
     }
-    if(!instance->l.empty())
+    if(!SIMLIB_state.wulist->l.empty())
         SIMLIB_internal_error(); // for sure
     INSTALL_HOOK(WUget_next, 0); // uninstall hook if empty
 }
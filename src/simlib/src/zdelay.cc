@@ -163,7 +163,7 @@ void ZDelayTimer::Behavior()
         (*i)->SampleIn();
     for( i=c->begin(); i!=c->end(); ++i) // store all new output values
         (*i)->SampleOut();
-    Activate( Time + dt );
+    Activate( SIMLIB_Time + dt );
 }
 
 /////////////////////////////////////////////////////////////////////////////
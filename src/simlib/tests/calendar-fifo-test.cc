@@ -0,0 +1,105 @@
+////////////////////////////////////////////////////////////////////////////
+// SIMLIB/C++ -- calendar implementations test
+//
+// all calendars ("list", "cq", "heap", "ladder") should dispatch
+// events in the same order:
+//   1) time
+//   2) priority (higher first)
+//   3) FIFO
+// checks static fill, hold model with many equal times and
+// rescheduling/passivation of scheduled events
+//
+#include "simlib.h"
+#include <vector>
+
+const int N     = 2000;    // number of events
+const int STEPS = 20000;   // number of dispatched events in hold model
+
+bool quantized;            // many equal activation times
+unsigned long hash;        // order of dispatched events
+unsigned long order;       // scheduling order counter
+long executed;
+int errors;
+
+class TestEvent;
+std::vector<TestEvent*> events;
+
+class TestEvent : public Event {
+  public:
+    int no;                // index in events
+    unsigned long seq;     // scheduling order
+    double at;             // scheduled activation time
+    TestEvent(int n) : no(n), seq(0) {}
+    void Schedule(double t) {
+        seq = ++order;
+        at = t;
+        Activate(t);
+    }
+    void Behavior();
+};
+
+// previous dispatched event
+static TestEvent *last = 0;
+static double last_t; static int last_p; static unsigned long last_s;
+static unsigned long last_order; // scheduling counter at last dispatch
+
+void TestEvent::Behavior() {
+    // check ordering against previous event (if both were scheduled then)
+    if (at != Time)
+        ++errors;
+    if (last && seq <= last_order) {
+        if (Time < last_t ||
+            (Time == last_t && Priority > last_p) ||
+            (Time == last_t && Priority == last_p && seq < last_s))
+            ++errors;
+    }
+    last = this; last_t = Time; last_p = Priority; last_s = seq;
+    last_order = order;
+    hash = hash * 31 + no;
+    if (++executed >= STEPS)
+        return;
+    // hold model: reschedule itself, quantized times give many ties
+    Priority = static_cast<Priority_t>(Random() < 0.5 ? 0 : 1 + (int)(3*Random()));
+    if (quantized)
+        Schedule(Time + static_cast<int>(Exponential(4.0)) * 0.25);
+    else
+        Schedule(Time + Exponential(1.0));
+    // sometimes move another scheduled event
+    if (Random() < 0.1) {
+        TestEvent *other = events[static_cast<int>(N*Random())];
+        if (other != this) {
+            other->Passivate();
+            other->Schedule(Time + static_cast<int>(8*Random()) * 0.25);
+        }
+    }
+}
+
+unsigned long Experiment(const char *calendar) {
+    SetCalendar(calendar);
+    Init(0);
+    RandomSeed(1234567);
+    hash = 0; order = 0; executed = 0; errors = 0; last = 0;
+    events.clear();
+    for (int i = 0; i < N; i++) {
+        TestEvent *e = new TestEvent(i);
+        e->Priority = static_cast<Entity::Priority_t>(i % 3);
+        events.push_back(e);
+        e->Schedule(static_cast<int>(10*Random()) * 0.5);   // static fill
+    }
+    Run();
+    Print("%-7s %s executed=%ld errors=%d order=%08lx\n",
+          calendar, quantized ? "quantized " : "continuous", executed, errors, hash & 0xffffffffUL);
+    return hash;
+}
+
+int main() {
+    Print("Calendar ordering test\n");
+    for (int q = 1; q >= 0; q--) {
+        quantized = q;
+        unsigned long ref = Experiment("list");
+        const char *cals[] = { "cq", "heap", "ladder" };
+        for (const char *c : cals)
+            if (Experiment(c) != ref)
+                Print("%s: different order than list\n", c);
+    }
+}
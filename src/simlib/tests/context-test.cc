@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////
+// SIMLIB/C++ -- SimulationContext test
+//
+// the same M/M/1 experiment should give the same results:
+//   - sequentially in the default context of main thread
+//   - in parallel threads (each thread has its own default context)
+//   - in two SimulationContext objects prepared and run alternately
+//
+#include "simlib.h"
+#include <string>
+#include <thread>
+
+const int N = 4;                // number of experiments
+
+// experiment: facility with exponential arrivals and service
+struct Experiment {
+    unsigned long seed;
+    Facility F;
+    Stat     S;
+    unsigned long served = 0;
+
+    struct Customer : public Process {
+        Experiment &e;
+        Customer(Experiment &x) : e(x) {}
+        void Behavior() {
+            double t0 = Time;
+            Seize(e.F);
+            Wait(Exponential(0.9));
+            Release(e.F);
+            e.S(Time - t0);
+            e.served++;
+        }
+    };
+    struct Generator : public Event {
+        Experiment &e;
+        Generator(Experiment &x) : e(x) {}
+        void Behavior() {
+            (new Customer(e))->Activate();
+            Activate(Time + Exponential(1));
+        }
+    };
+
+    Experiment(unsigned long s) : seed(s) {}
+    void Prepare() {            // initialization in the active context
+        Init(0, 2000);
+        RandomSeed(seed);
+        (new Generator(*this))->Activate();
+    }
+    std::string Result() {
+        char s[100];
+        snprintf(s, sizeof(s), "seed %lu: served %lu, mean %.6f, max %.6f",
+                 seed, served, S.MeanValue(), S.Max());
+        return s;
+    }
+};
+
+std::string RunExperiment(unsigned long seed) {
+    Experiment e(seed);
+    e.Prepare();
+    Run();
+    return e.Result();
+}
+
+int main() {
+    std::string sequential[N], parallel[N], alternate[2];
+    for (int i = 0; i < N; i++)
+        sequential[i] = RunExperiment(100 + i);
+
+    std::thread threads[N];
+    for (int i = 0; i < N; i++)
+        threads[i] = std::thread([i, &parallel] {
+            parallel[i] = RunExperiment(100 + i);
+        });
+    for (int i = 0; i < N; i++)
+        threads[i].join();
+
+    {
+        SimulationContext c0, c1;
+        c0.Select();
+        Experiment e0(100);
+        e0.Prepare();
+        c1.Select();
+        Experiment e1(101);
+        e1.Prepare();
+        c0.Select();
+        Run();
+        c1.Select();
+        Run();
+        SimulationContext::SelectDefault();
+        alternate[0] = e0.Result();
+        alternate[1] = e1.Result();
+    }
+
+    bool same = true;
+    for (int i = 0; i < N; i++) {
+        Print("%s\n", sequential[i].c_str());
+        same = same && sequential[i] == parallel[i];
+    }
+    same = same && alternate[0] == sequential[0] && alternate[1] == sequential[1];
+    Print("results %s\n", same ? "are identical" : "DIFFER");
+    return same ? 0 : 1;
+}
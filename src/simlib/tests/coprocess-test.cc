@@ -0,0 +1,127 @@
+////////////////////////////////////////////////////////////////////////////
+// SIMLIB/C++ -- CoProcess (C++20 coroutine process) test
+//
+// the same model written with Process and CoProcess should produce
+// the same trace:
+//   Wait, Seize/Release (with queue), Enter/Leave (with queue),
+//   Into+Passivate/Activate and Terminate
+// CoProcess uses pointers to locals across suspension points
+//
+#include "simlib.h"
+#include "coprocess.h"
+#include <string>
+#include <vector>
+
+const int N = 200;         // number of customers
+
+Facility  F("Facility");
+Store     S("Store", 3);
+Queue     Q("Queue");
+std::vector<std::string> trace[2];  // [0]=Process, [1]=CoProcess
+int model;                 // current model
+
+void Log(unsigned long id, const char *what) {
+    char s[100];
+    snprintf(s, sizeof(s), "%10.6f %3lu %s", (double)Time, id, what);
+    trace[model].push_back(s);
+}
+
+// wakes customers waiting in queue Q
+class Waker : public Event {
+    void Behavior() {
+        if (!Q.Empty())
+            Q.GetFirst()->Activate();
+        if (Time < 500)
+            Activate(Time + Exponential(3));
+    }
+};
+
+struct Customer : public Process {
+    unsigned long no;
+    Customer(unsigned long n) : no(n) {}
+    void Behavior() {
+        Log(no, "start");
+        Seize(F);
+        Log(no, "seized");
+        Wait(Exponential(1));
+        Release(F);
+        Enter(S, 2);
+        Log(no, "entered");
+        Wait(Exponential(2));
+        Leave(S, 2);
+        if (no % 5 == 0) {
+            Into(Q);
+            Passivate();
+            Log(no, "woken");
+        }
+        if (no % 7 == 0) {
+            Log(no, "terminate");
+            Terminate();
+        }
+        Log(no, "end");
+    }
+};
+
+struct CoCustomer : public CoProcess {
+    unsigned long no;
+    CoCustomer(unsigned long n) : no(n) {}
+    CoBehavior Behavior() override {
+        unsigned long local = no;
+        unsigned long *p = &local;      // pointer to local across suspension
+        Log(*p, "start");
+        co_await Seize(F);
+        Log(*p, "seized");
+        co_await Wait(Exponential(1));
+        Release(F);
+        co_await Enter(S, 2);
+        Log(*p, "entered");
+        co_await Wait(Exponential(2));
+        Leave(S, 2);
+        if (*p % 5 == 0) {
+            Into(Q);
+            co_await Passivate();
+            Log(*p, "woken");
+        }
+        if (*p % 7 == 0) {
+            Log(*p, "terminate");
+            Terminate();
+            co_return;
+        }
+        Log(*p, "end");
+    }
+};
+
+class Generator : public Event {
+    unsigned long n = 0;
+    void Behavior() {
+        ++n;
+        if (model == 0)
+            (new Customer(n))->Activate();
+        else
+            (new CoCustomer(n))->Activate();
+        if (n < N)
+            Activate(Time + Exponential(2));
+    }
+};
+
+int main() {
+    for (model = 0; model < 2; model++) {
+        Init(0, 1000);
+        RandomSeed(1234);
+        F.Clear();
+        S.Clear();
+        Q.Clear();
+        (new Generator)->Activate();
+        (new Waker)->Activate();
+        Run();
+        Print("model %s: %lu trace lines, live frames %lu\n",
+              model ? "CoProcess" : "Process",
+              (unsigned long)trace[model].size(),
+              (unsigned long)CoFrameArena::Instance().LiveFrames());
+    }
+    bool same = trace[0] == trace[1];
+    for (std::size_t i = 0; i < trace[1].size() && i < 20; i++)
+        Print("%s\n", trace[1][i].c_str());
+    Print("traces %s\n", same ? "are identical" : "DIFFER");
+    return same ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+////////////////////////////////////////////////////////////////////////////
+// SIMLIB/C++ -- test of QuantileHistogram
+//
+// quantiles of 10^6 exponential and log-normal values against exact order
+// statistics (relative error <= RelativeError()), merge of partial
+// histograms equals one histogram of all values, values outside the range
+//
+#include "simlib.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+const int N = 1000000;      // sample size
+const double P[] = { 0.5, 0.9, 0.95, 0.99, 0.999 };
+
+bool Check(const char *name, double (*gen)(), double low, double high, unsigned bits) {
+    bool ok = true;
+    QuantileHistogram h(name, low, high, bits);
+    QuantileHistogram part[4] = { {low, high, bits}, {low, high, bits},
+                                  {low, high, bits}, {low, high, bits} };
+    std::vector<double> v(N);
+    RandomSeed(30);
+    for (int i = 0; i < N; i++) {
+        v[i] = gen();
+        h(v[i]);
+        part[i % 4](v[i]);
+    }
+    std::sort(v.begin(), v.end());
+    Print("%s, bits %u, relative error %g\n", name, bits, h.RelativeError());
+    for (double p : P) {
+        double exact = v[long(ceil(p * N)) - 1];
+        double e = h.Quantile(p);
+        double err = fabs(e - exact) / exact;
+        bool good = err <= h.RelativeError();
+        Print("  p%-6g exact %-12.6g estimate %-12.6g %s\n", 100 * p, exact, e, good ? "ok" : "FAILED");
+        ok = ok && good;
+    }
+    if (h.Quantile(0) != v[0] || h.Quantile(1) != v[N - 1]) {
+        Print("  min/max differ\n");
+        ok = false;
+    }
+    for (int k = 1; k < 4; k++)
+        part[0].Merge(part[k]);
+    bool same = part[0].Number() == h.Number() && part[0].Min() == h.Min() && part[0].Max() == h.Max();
+    for (double p : P)
+        same = same && part[0].Quantile(p) == h.Quantile(p);
+    Print("  merge of 4 parts %s\n", same ? "ok" : "FAILED");
+    return ok && same;
+}
+
+double Exp() { return Exponential(0.1); }
+double LogNormal() { return exp(Normal(-2, 1)); }
+
+int main() {
+    bool all = true;
+    Print("Test of QuantileHistogram, n=%d\n", N);
+    SetBaseRandomGenerator(RandomXoshiro256);
+    all = Check("Exponential(0.1)", Exp, 1e-4, 10, 7) && all;
+    all = Check("exp(Normal(-2,1))", LogNormal, 1e-3, 100, 4) && all;
+
+    // values outside [low, high) are counted but have no error bound
+    QuantileHistogram h("range", 1, 8, 2);
+    for (double x : { 0.5, 0.25, 1.0, 3.0, 7.9, 8.0, 100.0 })
+        h(x);
+    Print("range [%g, %g): %lu values, %u buckets, p0 %g p50 %g p100 %g, mean %g\n",
+          h.Low(), h.High(), h.Number(), h.Buckets(), h.Quantile(0), h.Quantile(0.5),
+          h.Quantile(1), h.MeanValue());
+    all = all && h.Quantile(0) == 0.25 && h.Quantile(1) == 100 && h.Quantile(0.5) == 3.25;
+    h.Output();
+
+    Print("quantile histogram test %s\n", all ? "passed" : "FAILED");
+    return all ? 0 : 1;
+}
@@ -0,0 +1,58 @@
+////////////////////////////////////////////////////////////////////////////
+// SIMLIB/C++ -- throughput of random number generators
+//
+// ns per number for base generators (default LCG, xoshiro256++),
+// RandomFill and Normal/Exponential/Poisson (new and compatibility methods)
+// output is CSV: generator, method, ns_per_number
+//
+// (not a test model: timing differs in each run, use "make bench")
+//
+#include "simlib.h"
+#include <chrono>
+#include <cstdio>
+
+const long M = 20000000;    // numbers per measurement
+volatile double sink;       // prevents optimizing the loops out
+double buffer[4096];
+
+template <typename F>
+void Measure(const char *gen, const char *method, F f) {
+    RandomSeed(1);
+    auto start = std::chrono::steady_clock::now();
+    double sum = 0;
+    for (long i = 0; i < M; i++)
+        sum += f();
+    double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    sink = sum;
+    printf("%s,%s,%.2f\n", gen, method, t * 1e9 / M);
+}
+
+int main() {
+    printf("generator,method,ns_per_number\n");
+    for (int gen = 0; gen < 2; gen++) {
+        SetBaseRandomGenerator(gen ? RandomXoshiro256 : 0);
+        const char *g = gen ? "xoshiro256++" : "LCG";
+        Measure(g, "Random", [] { return Random(); });
+        RandomSeed(1);
+        auto start = std::chrono::steady_clock::now();
+        double sum = 0;
+        for (long i = 0; i < M; i += 4096) {
+            RandomFill(buffer, 4096);
+            sum += buffer[0];
+        }
+        double t = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        sink = sum;
+        printf("%s,RandomFill,%.2f\n", g, t * 1e9 / M);
+        for (int compat = 0; compat < 2; compat++) {
+            SetRandomCompatibility(compat);
+            Measure(g, compat ? "Normal-compat" : "Normal-ziggurat",
+                    [] { return Normal(0, 1); });
+            Measure(g, compat ? "Exponential-compat" : "Exponential-ziggurat",
+                    [] { return Exponential(1); });
+            Measure(g, compat ? "Poisson(2000)-compat" : "Poisson(2000)-PTRS",
+                    [] { return double(Poisson(2000)); });
+        }
+        SetRandomCompatibility(false);
+    }
+    return 0;
+}
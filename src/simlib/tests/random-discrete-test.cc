@@ -0,0 +1,122 @@
+////////////////////////////////////////////////////////////////////////////
+// SIMLIB/C++ -- test of Poisson() and Binom() generators
+//
+// chi-square goodness of fit against exact probabilities (classes with
+// expected count < 5 are merged), mean and variance; PoissonFill and
+// BinomFill give the same numbers as single calls
+//
+#include "simlib.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+const int N = 200000;       // sample size
+std::vector<int> a(N), b(N);
+
+// chi-square statistic divided by critical value (0.1%, Wilson-Hilferty)
+double ChiSquare(const std::vector<int> &v, double (*logpmf)(long, double, double),
+                 double p1, double p2, long lo, long hi) {
+    std::vector<long> count(hi - lo + 1, 0);
+    for (int x : v)
+        if (x >= lo && x <= hi)
+            count[x - lo]++;
+    double chi2 = 0, expected = 0, observed = 0;
+    int df = -1;
+    double pin = 0;
+    for (long k = lo; k <= hi; k++) {
+        double p = exp(logpmf(k, p1, p2));
+        pin += p;
+        expected += N * p;
+        observed += count[k - lo];
+        if (expected >= 5) {
+            chi2 += (observed - expected) * (observed - expected) / expected;
+            df++;
+            expected = observed = 0;
+        }
+    }
+    long outside = 0;           // rest of distribution (both tails)
+    for (int x : v)
+        if (x < lo || x > hi)
+            outside++;
+    expected += N * (1 - pin);
+    observed += outside;
+    if (expected > 0) {
+        chi2 += (observed - expected) * (observed - expected) / expected;
+        df++;
+    }
+    double c = 1 - 2.0 / (9 * df) + 3.09 * sqrt(2.0 / (9 * df));
+    return chi2 / (df * c * c * c);
+}
+
+double PoissonLogPmf(long k, double l, double) {
+    return -l + k * log(l) - lgamma(k + 1.0);
+}
+double BinomLogPmf(long k, double n, double p) {
+    if (p == 0 || p == 1)
+        return (k == (p == 0 ? 0 : n)) ? 0 : -1e300;
+    return lgamma(n + 1) - lgamma(k + 1.0) - lgamma(n - k + 1) + k * log(p) + (n - k) * log(1 - p);
+}
+
+bool Report(const char *name, const std::vector<int> &v, double mean, double var, double chi) {
+    double s = 0, s2 = 0;
+    for (int x : v) {
+        s += x;
+        s2 += double(x) * x;
+    }
+    double m = s / N, d = s2 / N - m * m;
+    bool ok = chi < 1 && fabs(m - mean) < 5 * sqrt(var / N) + 1e-12 &&
+              fabs(d - var) < 0.05 * var + 1e-12;
+    Print("%-24s mean %12.4f (%12.4f)  var %12.4f (%12.4f)  chi2/crit %.3f  %s\n",
+          name, m, mean, d, var, chi, ok ? "ok" : "FAILED");
+    return ok;
+}
+
+int main() {
+    bool all = true;
+    char s[100];
+    Print("Test of Poisson() and Binom(), n=%d\n", N);
+    SetBaseRandomGenerator(RandomXoshiro256);
+
+    for (double l : {0.5, 3.0, 9.5, 10.0, 50.0, 2000.0, 1e6}) {
+        RandomSeed(10);
+        for (int i = 0; i < N; i++)
+            a[i] = Poisson(l);
+        RandomSeed(10);
+        PoissonFill(l, b.data(), N);
+        double sd = sqrt(l);
+        long lo = std::max(0L, long(l - 6 * sd)), hi = long(l + 6 * sd) + 5;
+        snprintf(s, sizeof(s), "Poisson(%g)", l);
+        all = Report(s, a, l, l, ChiSquare(a, PoissonLogPmf, l, 0, lo, hi)) && all;
+        if (a != b) {
+            Print("  PoissonFill differs\n");
+            all = false;
+        }
+    }
+
+    struct { int n; double p; } binom[] = {
+        {20, 0.2}, {100, 0.05}, {100, 0.5}, {1000, 0.3}, {1000, 0.9},
+        {100000, 0.01}, {5, 1.0}, {7, 0.0}
+    };
+    for (auto &t : binom) {
+        RandomSeed(20);
+        for (int i = 0; i < N; i++)
+            a[i] = Binom(t.n, t.p);
+        RandomSeed(20);
+        BinomFill(t.n, t.p, b.data(), N);
+        double mean = t.n * t.p, var = t.n * t.p * (1 - t.p);
+        snprintf(s, sizeof(s), "Binom(%d,%g)", t.n, t.p);
+        double chi = 0;
+        if (var > 0) {
+            double sd = sqrt(var);
+            long lo = std::max(0L, long(mean - 6 * sd)), hi = std::min(long(t.n), long(mean + 6 * sd) + 5);
+            chi = ChiSquare(a, BinomLogPmf, t.n, t.p, lo, hi);
+        }
+        all = Report(s, a, mean, var, chi) && all;
+        if (a != b) {
+            Print("  BinomFill differs\n");
+            all = false;
+        }
+    }
+    Print("discrete distributions test %s\n", all ? "passed" : "FAILED");
+    return all ? 0 : 1;
+}
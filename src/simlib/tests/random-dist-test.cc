@@ -0,0 +1,77 @@
+////////////////////////////////////////////////////////////////////////////
+// SIMLIB/C++ -- distribution quality test of Normal() and Exponential()
+//
+// Kolmogorov-Smirnov and Anderson-Darling statistics of samples
+// against the exact distribution function, for ziggurat methods
+// (default) and old methods (SetRandomCompatibility)
+//   critical values (5%):  KS: sqrt(n)*D < 1.358,  AD: A2 < 2.492
+//
+#include "simlib.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+const int N = 200000;       // sample size
+
+double NormalCDF(double x) { return 0.5 * erfc(-x / sqrt(2.0)); }
+double ExponentialCDF(double x) { return 1.0 - exp(-x); }
+
+// computes KS and AD statistics, returns true if both pass
+bool Check(const char *name, std::vector<double> &v, double (*cdf)(double)) {
+    std::sort(v.begin(), v.end());
+    const int n = v.size();
+    std::vector<double> F(n);
+    double d = 0, a2 = 0;
+    for (int i = 0; i < n; i++) {
+        F[i] = std::min(std::max(cdf(v[i]), 1e-300), 1 - 1e-16);
+        d = std::max(d, std::max((i + 1.0) / n - F[i], F[i] - double(i) / n));
+    }
+    for (int i = 0; i < n; i++)
+        a2 += (2.0 * i + 1) * (log(F[i]) + log(1 - F[n - 1 - i]));
+    a2 = -n - a2 / n;
+    double ks = sqrt(double(n)) * d;
+    bool ok = ks < 1.358 && a2 < 2.492;
+    Print("%-28s KS %.4f  AD %.4f  min %8.4f  max %8.4f  %s\n", name, ks, a2,
+          v[0], v[n - 1], ok ? "ok" : "REJECTED");
+    return ok;
+}
+
+int main() {
+    std::vector<double> v(N);
+    bool all = true;
+    Print("Distribution test of Normal() and Exponential(), n=%d\n", N);
+    for (int compat = 0; compat < 2; compat++) {
+        SetRandomCompatibility(compat);
+        Print("%s:\n", compat ? "compatibility methods" : "ziggurat methods");
+        for (int gen = 0; gen < 2; gen++) {
+            SetBaseRandomGenerator(gen ? RandomXoshiro256 : 0);
+            const char *g = gen ? "xoshiro" : "LCG";
+            char s[100];
+            RandomSeed(1);
+            for (int i = 0; i < N; i++)
+                v[i] = Normal(0, 1);
+            snprintf(s, sizeof(s), "  Normal(0,1), %s", g);
+            bool ok = Check(s, v, NormalCDF);
+            RandomSeed(2);
+            for (int i = 0; i < N; i++)
+                v[i] = Exponential(1);
+            snprintf(s, sizeof(s), "  Exponential(1), %s", g);
+            ok = Check(s, v, ExponentialCDF) && ok;
+            if (!compat)        // old methods are reported only
+                all = all && ok;
+        }
+    }
+    // tail of normal distribution: P(|x|>4) = 6.334e-5
+    SetRandomCompatibility(false);
+    SetBaseRandomGenerator(RandomXoshiro256);
+    RandomSeed(3);
+    long tail = 0;
+    const long M = 10000000;
+    for (long i = 0; i < M; i++)
+        if (fabs(Normal(0, 1)) > 4)
+            tail++;
+    Print("Normal tail |x|>4: %ld of %ld (expected %.0f)\n", tail, M, 6.334e-5 * M);
+    all = all && fabs(tail - 6.334e-5 * M) < 4 * sqrt(6.334e-5 * M);
+    Print("distribution test %s\n", all ? "passed" : "FAILED");
+    return all ? 0 : 1;
+}
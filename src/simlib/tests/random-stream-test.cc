@@ -0,0 +1,129 @@
+////////////////////////////////////////////////////////////////////////////
+// SIMLIB/C++ -- test of RandomStream (xoshiro256++) and RandomFill
+//
+//   - RandomSeed() repeats the sequence of streams and base generators
+//   - RandomFill() gives the same numbers as Random() (LCG and xoshiro)
+//   - named streams differ, replications differ and repeat
+//   - SetRandomStream() selects the stream of Random() and distributions
+//   - mean and variance of uniform distribution
+//
+#include "simlib.h"
+#include <cmath>
+
+const int N = 1000;
+double a[N], b[N];
+
+bool Same(const double *x, const double *y, int n) {
+    for (int i = 0; i < n; i++)
+        if (x[i] != y[i])
+            return false;
+    return true;
+}
+
+const char *Result(bool ok) { return ok ? "ok" : "FAILED"; }
+
+int main() {
+    bool ok, all = true;
+    Print("Test of RandomStream and RandomFill\n");
+
+    // RandomFill with default LCG and xoshiro256++ base generators
+    for (int gen = 0; gen < 2; gen++) {
+        SetBaseRandomGenerator(gen ? RandomXoshiro256 : 0);
+        RandomSeed(1234);
+        for (int i = 0; i < N; i++)
+            a[i] = Random();
+        RandomSeed(1234);
+        RandomFill(b, N / 2);
+        RandomFill(b + N / 2, N / 2);
+        Print("%s: first %.12f, last %.12f\n",
+              gen ? "RandomXoshiro256" : "default LCG", a[0], a[N - 1]);
+        Print("  RandomFill == Random(): %s\n", Result(ok = Same(a, b, N)));
+        all = all && ok;
+    }
+    SetBaseRandomGenerator(0);
+
+    // named streams
+    RandomStream arrivals("arrivals"), service("service");
+    RandomSeed(42);
+    for (int i = 0; i < N; i++)
+        a[i] = arrivals();
+    service.Fill(b, N);
+    Print("arrivals: %.12f %.12f\n", a[0], a[1]);
+    Print("service:  %.12f %.12f\n", b[0], b[1]);
+    Print("  streams differ: %s\n", Result(ok = !Same(a, b, N)));
+    all = all && ok;
+    RandomSeed(42);             // reseeds the streams
+    arrivals.Fill(b, N);
+    Print("  RandomSeed repeats stream: %s\n", Result(ok = Same(a, b, N)));
+    all = all && ok;
+
+    // replications: independent states, replication 0 is RandomSeed(seed)
+    RandomSeed(42, 3);
+    arrivals.Fill(a, N);
+    RandomSeed(42, 4);
+    arrivals.Fill(b, N);
+    Print("arrivals, replication 3: %.12f\n", a[0]);
+    Print("  replications differ: %s\n", Result(ok = !Same(a, b, N)));
+    all = all && ok;
+    RandomSeed(42, 3);
+    arrivals.Fill(b, N);
+    Print("  RandomSeed repeats replication: %s\n", Result(ok = Same(a, b, N)));
+    all = all && ok;
+    RandomSeed(42, 0);
+    arrivals.Fill(b, N);
+    RandomSeed(42);
+    arrivals.Fill(a, N);
+    Print("  replication 0 == RandomSeed(seed): %s\n", Result(ok = Same(a, b, N)));
+    all = all && ok;
+    RandomSeed(42);
+    arrivals.Fill(a, N);
+    RandomSeed(42);
+    arrivals.Jump();
+    arrivals.Fill(b, N);
+    Print("  Jump changes stream: %s\n", Result(ok = !Same(a, b, N)));
+    all = all && ok;
+
+    // selected stream of RandomXoshiro256: Random() and distributions
+    SetBaseRandomGenerator(RandomXoshiro256);
+    RandomSeed(42);
+    service.Fill(a, N);
+    RandomSeed(42);
+    RandomStream *previous = SetRandomStream(&service);
+    for (int i = 0; i < N; i++)
+        b[i] = Random();
+    SetRandomStream(previous);
+    Print("  Random() from selected stream: %s\n", Result(ok = previous == 0 && Same(a, b, N)));
+    all = all && ok;
+    RandomSeed(42);
+    double d0 = Random();       // first number of default stream
+    RandomSeed(42);
+    SetRandomStream(&service);
+    double n1 = Normal(0, 1);
+    SetRandomStream(0);
+    double d1 = Random();       // default stream not used by Normal()
+    RandomSeed(42);
+    SetRandomStream(&service);
+    double n2 = Normal(0, 1);
+    SetRandomStream(0);
+    Print("  Normal() from selected stream: %s\n", Result(ok = n1 == n2 && d1 == d0));
+    all = all && ok;
+    SetBaseRandomGenerator(0);
+
+    // uniform distribution: mean 1/2, variance 1/12
+    RandomStream s("statistics");
+    double sum = 0, sum2 = 0;
+    const int M = 1000000;
+    for (int i = 0; i < M; i++) {
+        double x = s();
+        sum += x;
+        sum2 += x * x;
+    }
+    double mean = sum / M, var = sum2 / M - mean * mean;
+    Print("mean %.4f, variance %.4f\n", mean, var);
+    Print("  uniform moments: %s\n",
+          Result(ok = fabs(mean - 0.5) < 0.002 && fabs(var - 1.0 / 12) < 0.001));
+    all = all && ok;
+
+    Print("RandomStream test %s\n", all ? "passed" : "FAILED");
+    return all ? 0 : 1;
+}
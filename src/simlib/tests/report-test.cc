@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////
+// SIMLIB/C++ -- test of structured output (OutputStatistics)
+//
+//   - small queueing model, all its statistics objects registered
+//   - the same objects in text, JSON and binary format
+//   - binary report has exact values of fields (checked against objects)
+//   - destroyed objects are removed from the list
+//
+#include "simlib.h"
+#include <cstring>
+#include <string>
+
+bool all = true;
+
+void Check(const char *what, bool ok) {
+    Print("  %-44s %s\n", what, ok ? "ok" : "FAILED");
+    all = all && ok;
+}
+
+Facility Server("Server");
+Store Pool("Pool", 2);
+Histogram Table("Time in system", 0, 1, 5);
+QuantileHistogram Quantiles("Time in system quantiles", 0.1, 10, 2);
+
+class Customer : public Process {
+    void Behavior() {
+        double t0 = Time;
+        Enter(Pool, 1);
+        Seize(Server);
+        Wait(Exponential(0.4));
+        Release(Server);
+        Leave(Pool, 1);
+        Table(Time - t0);
+        Quantiles(Time - t0);
+    }
+};
+
+class Generator : public Event {
+    void Behavior() {
+        (new Customer)->Activate();
+        Activate(Time + Exponential(0.5));
+    }
+};
+
+// field of top level object in binary report: returns its double value
+// (tag 'd') or number of top level objects if field == nullptr
+double BinaryField(const std::string &r, const char *type, const char *field) {
+    size_t p = 8 + sizeof(double);
+    int depth = 0, objects = 0;
+    const char *current = "";
+    while (p < r.size() && r[p] != 'Z') {
+        char tag = r[p++];
+        if (tag == 'E') { depth--; continue; }
+        unsigned klen = (unsigned char)r[p++];
+        std::string key = r.substr(p, klen);
+        p += klen;
+        switch (tag) {
+        case 'O': {
+            unsigned tlen = (unsigned char)r[p++];
+            std::string t = r.substr(p, tlen);
+            p += tlen;
+            uint32_t nlen;
+            memcpy(&nlen, &r[p], 4);
+            p += 4 + nlen;
+            if (depth++ == 0) {
+                objects++;
+                current = (t == type) ? type : "";
+            }
+            break;
+        }
+        case 'd': {
+            double x;
+            memcpy(&x, &r[p], 8);
+            p += 8;
+            if (field && depth == 1 && *current && key == field)
+                return x;
+            break;
+        }
+        case 'u': p += 8; break;
+        case 's': { uint32_t n; memcpy(&n, &r[p], 4); p += 4 + n; break; }
+        case 'a': { uint32_t n; memcpy(&n, &r[p], 4); p += 4 + 8 * n; break; }
+        default: return -1;
+        }
+    }
+    return field ? -1 : objects;
+}
+
+int main() {
+    Print("Test of structured output of statistics\n");
+    SetBaseRandomGenerator(RandomXoshiro256);
+    RandomSeed(50);
+    Init(0, 20);
+    (new Generator)->Activate();
+    Run();
+
+    OutputRegister(Server);
+    OutputRegister(Pool);
+    OutputRegister(Table);
+    OutputRegister(Quantiles);
+    OutputRegister(Table.stat);
+    OutputRegister(Table);              // only once
+
+    Print("--- text\n");
+    OutputStatistics();                 // default format: Output()
+    Print("--- json\n");
+    SetOutputFormat("json");
+    OutputStatistics();
+
+    std::string r = ReportStatistics("binary");
+    Print("--- binary: %u bytes\n", (unsigned)r.size());
+    Check("header and end", r.compare(0, 8, "SIMLIBR1") == 0 && r.back() == 'Z');
+    Check("5 objects", BinaryField(r, "", nullptr) == 5);
+    Check("exact mean and deviation of stat",
+          BinaryField(r, "stat", "mean") == Table.stat.MeanValue() &&
+          BinaryField(r, "stat", "stddev") == Table.stat.StdDev());
+    Check("exact p99 of quantiles",
+          BinaryField(r, "quantiles", "p99") == Quantiles.Quantile(0.99));
+
+    {
+        Stat local("local");
+        OutputRegister(local);
+        Check("6 objects with local stat", BinaryField(ReportStatistics("binary"), "", nullptr) == 6);
+    }
+    Check("5 objects after its destruction", BinaryField(ReportStatistics("binary"), "", nullptr) == 5);
+    OutputUnregister(Table.stat);
+    Check("4 objects after OutputUnregister", BinaryField(ReportStatistics("binary"), "", nullptr) == 4);
+
+    Print("structured output test %s\n", all ? "passed" : "FAILED");
+    return all ? 0 : 1;
+}
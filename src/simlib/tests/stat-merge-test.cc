@@ -0,0 +1,96 @@
+////////////////////////////////////////////////////////////////////////////
+// SIMLIB/C++ -- test of Stat and TStat accumulators
+//
+//   - standard deviation of 10^6 values 1e9+Random() (sums of squares
+//     would cancel completely)
+//   - Merge of 8 partial statistics equals one statistic of all values
+//     (up to rounding: values 1e9+r are stored with step 1.2e-7)
+//   - Serialize/Deserialize gives the same statistic
+//   - TStat of a step function, merged over two experiments
+//
+#include "simlib.h"
+#include <cmath>
+#include <string>
+
+const int N = 1000000;          // sample size
+bool all = true;
+
+void Check(const char *what, bool ok) {
+    Print("  %-44s %s\n", what, ok ? "ok" : "FAILED");
+    all = all && ok;
+}
+
+bool Near(double a, double b, double eps) {
+    return fabs(a - b) <= eps * fabs(b);
+}
+
+// TStat of a step function: value base+k in time [k, k+1), k = 0..9
+TStat Steps("step function");
+double base;
+
+class Step : public Event {
+    void Behavior() {
+        Steps(base + Time);
+        if (Time < 9)
+            Activate(Time + 1);
+    }
+};
+
+void Experiment(double b) {
+    Init(0, 10);
+    Steps.Clear(b);
+    base = b;
+    (new Step)->Activate();
+    Run();
+}
+
+int main() {
+    Print("Test of Stat and TStat (Welford, Merge, Serialize)\n");
+    SetBaseRandomGenerator(RandomXoshiro256);
+    RandomSeed(40);
+
+    Stat s("1e9 + Random()"), part[8];
+    for (int i = 0; i < N; i++) {
+        double x = 1e9 + Random();
+        s(x);
+        part[i % 8](x);
+    }
+    Print("Stat: n = %lu, mean - 1e9 = %.6f, std. deviation = %.6f\n",
+          s.Number(), s.MeanValue() - 1e9, s.StdDev());
+    Check("std. deviation of uniform 1/sqrt(12)", Near(s.StdDev(), 1 / sqrt(12.0), 2e-3));
+
+    Stat merged;
+    for (Stat &p : part)
+        merged.Merge(p);
+    Check("merge of 8 parts: n, min, max",
+          merged.Number() == s.Number() && merged.Min() == s.Min() && merged.Max() == s.Max());
+    Check("merge of 8 parts: mean, std. deviation",
+          Near(merged.MeanValue(), s.MeanValue(), 1e-14) && Near(merged.StdDev(), s.StdDev(), 1e-6));
+
+    std::string image = s.Serialize();
+    Stat copy;
+    copy.Deserialize(image);
+    Print("Stat image: %u bytes\n", (unsigned)image.size());
+    Check("Deserialize(Serialize())",
+          copy.Number() == s.Number() && copy.MeanValue() == s.MeanValue() &&
+          copy.StdDev() == s.StdDev() && copy.Min() == s.Min() && copy.Max() == s.Max());
+
+    Experiment(0);
+    Print("TStat: mean %g, std. deviation %g\n", Steps.MeanValue(), Steps.StdDev());
+    Check("time-weighted mean and std. deviation of 0..9",
+          Near(Steps.MeanValue(), 4.5, 1e-15) && Near(Steps.StdDev(), sqrt(99 / 12.0), 1e-15));
+    std::string first = Steps.Serialize();
+
+    Experiment(10);                     // values 10..19
+    TStat previous;
+    previous.Deserialize(first);
+    Steps.Merge(previous);
+    Print("TStat merged: n %lu, mean %g, std. deviation %g, min %g, max %g\n",
+          Steps.Number(), Steps.MeanValue(), Steps.StdDev(), Steps.Min(), Steps.Max());
+    Check("merged experiments give statistic of 0..19",
+          Near(Steps.MeanValue(), 9.5, 1e-15) && Near(Steps.StdDev(), sqrt(399 / 12.0), 1e-15) &&
+          Steps.Number() == 20 && Steps.Min() == 0 && Steps.Max() == 19);
+
+    Print("Stat/TStat test %s\n", all ? "passed" : "FAILED");
+    return all ? 0 : 1;
+}
@@ -0,0 +1,53 @@
+/*
+ *  Název: Množina obsazených pozic kontejnerů (bitová mapa)
+ *
+ *  Bit i je nastaven, pokud je kontejner s id i aktivní. Přidání kontejneru
+ *  hledá nejnižší volnou pozici, odebrání nejvyšší obsazenou - stejně jako
+ *  původní lineární průchody polem kontejnerů, jen po 64bitových slovech.
+ *
+ *  Operace:  Set/Clear/Test            O(1)
+ *            FirstClear/LastSet        O(n / 64)
+ */
+
+#ifndef SLOT_SET_HPP
+#define SLOT_SET_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class SlotSet {
+public:
+    explicit SlotSet(int capacity = 0) : size(capacity), words((capacity + 63) / 64, 0) {}
+
+    int Capacity() const { return size; }
+    bool Test(int id) const { return (words[id >> 6] >> (id & 63)) & 1; }
+    void Set(int id) { words[id >> 6] |= uint64_t(1) << (id & 63); }
+    void Clear(int id) { words[id >> 6] &= ~(uint64_t(1) << (id & 63)); }
+
+    // Nejnižší nenastavená pozice, -1 pokud jsou všechny obsazené
+    int FirstClear() const {
+        for (size_t w = 0; w < words.size(); w++) {
+            if (~words[w] != 0) {
+                int id = (int)(w * 64) + __builtin_ctzll(~words[w]);
+                return (id < size) ? id : -1;
+            }
+        }
+        return -1;
+    }
+
+    // Nejvyšší nastavená pozice, -1 pokud je množina prázdná
+    int LastSet() const {
+        for (size_t w = words.size(); w-- > 0;) {
+            if (words[w] != 0)
+                return (int)(w * 64) + 63 - __builtin_clzll(words[w]);
+        }
+        return -1;
+    }
+
+private:
+    int size;                      // Počet pozic
+    std::vector<uint64_t> words;   // Bity pozic po 64
+};
+
+#endif
@@ -0,0 +1,391 @@
+/*
+ *  Název: Binární trace zátěže mapovaný do paměti
+ *
+ *  Formát souboru (little-endian):
+ *    hlavička  TraceHeader (24 B): magic, verze, délka intervalu v sekundách,
+ *              počet záznamů
+ *    data      "SIMTRACE": uint32 - počet požadavků v každém intervalu
+ *              "SIMREQST": RequestRecord - příchody jednotlivých požadavků
+ *                          seřazené podle času (interval v hlavičce je 0)
+ *
+ *  Oba typy trace se mapují do paměti (mmap) a čtou sekvenčně. Stránky
+ *  dostatečně daleko za posledním čteným záznamem se vrací jádru
+ *  (MADV_DONTNEED), takže obsazená paměť nezávisí na délce trace.
+ *  TraceWriter zapisuje záznamy proudově, ConvertCsvTrace a
+ *  ConvertCsvRequestTrace převádí CSV.
+ */
+
+#ifndef TRACE_HPP
+#define TRACE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fstream>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+struct TraceHeader {
+    char magic[8];          // "SIMTRACE"
+    uint32_t version;       // TRACE_VERSION
+    uint32_t interval;      // Délka intervalu jednoho záznamu v sekundách
+    uint64_t records;       // Počet záznamů
+};
+
+struct RequestRecord {
+    double time;            // Čas příchodu v sekundách od začátku trace
+    double service_demand;  // Doba zpracování požadavku bez zátěže v sekundách
+};
+
+const char TRACE_MAGIC[8] = {'S', 'I', 'M', 'T', 'R', 'A', 'C', 'E'};
+const char REQUEST_TRACE_MAGIC[8] = {'S', 'I', 'M', 'R', 'E', 'Q', 'S', 'T'};
+const uint32_t TRACE_VERSION = 1;
+
+
+/* MAPOVANÝ SOUBOR TRACE */
+// Společný základ čtení: mapování, kontrola hlavičky a správa stránek
+class MappedTrace {
+public:
+    MappedTrace() {}
+    ~MappedTrace() { Close(); }
+    MappedTrace(const MappedTrace&) = delete;
+    MappedTrace& operator=(const MappedTrace&) = delete;
+
+    void Close() {
+        if (base != nullptr)
+            munmap(const_cast<char*>(base), size);
+        base = nullptr;
+        records = 0;
+    }
+
+    bool IsOpen() const { return base != nullptr; }
+    const std::string& Error() const { return error; }
+    int Interval() const { return interval; }               // Délka záznamu v sekundách
+    uint64_t Records() const { return records; }
+
+protected:
+    static const size_t RELEASE_CHUNK = 1 << 20;    // Stránky vracíme po 1 MiB
+
+    const char* base = nullptr;
+    size_t size = 0;
+    uint64_t records = 0;
+    int interval = 0;
+    size_t page = 4096;
+    size_t released = 0;    // Stránky před tímto offsetem jsou vrácené jádru
+    std::string error;
+
+    // Namapuje soubor s daným magic, při chybě vrací false (popis v Error())
+    bool Map(const std::string& path, const char* magic, size_t record_size) {
+        Close();
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return Fail(path + ": " + strerror(errno));
+        struct stat st;
+        if (fstat(fd, &st) < 0 || st.st_size < (off_t)sizeof(TraceHeader)) {
+            close(fd);
+            return Fail(path + ": není trace (chybí hlavička)");
+        }
+        size = st.st_size;
+        void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);  // Mapování zůstává platné i po zavření souboru
+        if (p == MAP_FAILED)
+            return Fail(path + ": " + strerror(errno));
+        base = static_cast<const char*>(p);
+        madvise(p, size, MADV_SEQUENTIAL);
+
+        const TraceHeader* h = reinterpret_cast<const TraceHeader*>(base);
+        if (memcmp(h->magic, magic, sizeof(TRACE_MAGIC)) != 0 || h->version != TRACE_VERSION)
+            return Fail(path + ": neznámý formát trace");
+        if (h->records == 0 || h->records > (size - sizeof(TraceHeader)) / record_size)
+            return Fail(path + ": poškozená hlavička trace");
+        interval = h->interval;
+        records = h->records;
+        page = sysconf(_SC_PAGESIZE);
+        released = 0;
+        return true;
+    }
+
+    bool Fail(const std::string& message) {
+        Close();
+        error = message;
+        return false;
+    }
+
+    // Vrátí jádru stránky víc než RELEASE_CHUNK za čteným offsetem
+    void Release(size_t offset) {
+        if (offset < released) {            // Návrat na začátek trace
+            released = offset / page * page;
+            return;
+        }
+        if (offset - released < 2 * RELEASE_CHUNK)
+            return;
+        size_t end = (offset - RELEASE_CHUNK) / page * page;
+        madvise(const_cast<char*>(base) + released, end - released, MADV_DONTNEED);
+        released = end;
+    }
+
+    // Požádá jádro o asynchronní načtení stránek (MADV_WILLNEED)
+    void Prefetch(size_t offset, size_t length) {
+        if (offset >= size)
+            return;
+        size_t start = offset / page * page;
+        length = std::min(length + (offset - start), size - start);
+        madvise(const_cast<char*>(base) + start, length, MADV_WILLNEED);
+    }
+};
+
+
+/* ČTENÍ TRACE INTENZIT */
+class TraceReader : public MappedTrace {
+public:
+    bool Open(const std::string& path) {
+        if (!Map(path, TRACE_MAGIC, sizeof(uint32_t)))
+            return false;
+        if (interval == 0)
+            return Fail(path + ": poškozená hlavička trace");
+        data = reinterpret_cast<const uint32_t*>(base + sizeof(TraceHeader));
+        return true;
+    }
+
+    double Duration() const { return (double)records * interval; }
+
+    // Záznam i; po konci dat se trace opakuje od začátku
+    uint32_t At(uint64_t i) {
+        i %= records;
+        Release(sizeof(TraceHeader) + i * sizeof(uint32_t));
+        return data[i];
+    }
+
+    // Součet count záznamů od first (agregace do delšího intervalu)
+    uint64_t Sum(uint64_t first, uint64_t count) {
+        uint64_t sum = 0;
+        for (uint64_t i = 0; i < count; i++)
+            sum += At(first + i);
+        return sum;
+    }
+
+private:
+    const uint32_t* data = nullptr;
+};
+
+
+/* ČTENÍ TRACE POŽADAVKŮ */
+// Přehrávání po dávkách: na začátku každé dávky se vyžádá načtení
+// následující dávky (jádro ji čte, zatímco se simuluje aktuální)
+// a vrátí se stránky za kurzorem
+class RequestTraceReader : public MappedTrace {
+public:
+    static const uint64_t BATCH = 1 << 16;  // Záznamů v dávce (1 MiB)
+
+    bool Open(const std::string& path) {
+        if (!Map(path, REQUEST_TRACE_MAGIC, sizeof(RequestRecord)))
+            return false;
+        data = reinterpret_cast<const RequestRecord*>(base + sizeof(TraceHeader));
+        return true;
+    }
+
+    // Čas posledního příchodu
+    double Duration() const { return data[records - 1].time; }
+
+    // Záznam i při sekvenčním přehrávání
+    const RequestRecord& Replay(uint64_t i) {
+        if (i % BATCH == 0) {
+            size_t offset = sizeof(TraceHeader) + i * sizeof(RequestRecord);
+            Prefetch(offset + BATCH * sizeof(RequestRecord), BATCH * sizeof(RequestRecord));
+            Release(offset);
+        }
+        return data[i];
+    }
+
+    // Index prvního záznamu od from s časem >= time (záznamy nejsou vraceny
+    // jádru, určeno pro čtení před kurzorem přehrávání)
+    uint64_t Seek(double time, uint64_t from) const {
+        while (from < records && data[from].time < time)
+            from++;
+        return from;
+    }
+
+private:
+    const RequestRecord* data = nullptr;
+};
+
+
+/* ZÁPIS TRACE */
+class TraceWriter {
+public:
+    ~TraceWriter() { if (file != nullptr) fclose(file); }
+
+    // Trace intenzit (magic TRACE_MAGIC) nebo požadavků (REQUEST_TRACE_MAGIC, interval 0)
+    bool Open(const std::string& path, uint32_t interval, const char* magic = TRACE_MAGIC) {
+        file = fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+        this->interval = interval;
+        this->magic = magic;
+        records = 0;
+        return WriteHeader();   // Počet záznamů doplní Close()
+    }
+
+    bool Write(uint32_t requests) {
+        records++;
+        return fwrite(&requests, sizeof(requests), 1, file) == 1;
+    }
+
+    bool Write(const RequestRecord& request) {
+        records++;
+        return fwrite(&request, sizeof(request), 1, file) == 1;
+    }
+
+    uint64_t Records() const { return records; }
+
+    bool Close() {
+        bool ok = fseek(file, 0, SEEK_SET) == 0 && WriteHeader();
+        ok = (fclose(file) == 0) && ok;
+        file = nullptr;
+        return ok;
+    }
+
+private:
+    FILE* file = nullptr;
+    const char* magic = TRACE_MAGIC;
+    uint32_t interval = 0;
+    uint64_t records = 0;
+
+    bool WriteHeader() {
+        TraceHeader h;
+        memcpy(h.magic, magic, sizeof(TRACE_MAGIC));
+        h.version = TRACE_VERSION;
+        h.interval = interval;
+        h.records = records;
+        return fwrite(&h, sizeof(h), 1, file) == 1;
+    }
+};
+
+
+/* PŘEVOD CSV -> TRACE */
+// Jeden interval na řádek, počet požadavků je poslední sloupec (případný
+// první sloupec s časem se ignoruje). Nečíselný první řádek je záhlaví,
+// prázdné řádky a řádky začínající '#' se přeskakují. Soubor se čte po
+// řádcích, takže paměť nezávisí na jeho délce.
+// Vrací počet záznamů, při chybě -1 a popis v error.
+inline long ConvertCsvTrace(const std::string& csv_path, const std::string& trace_path,
+                            uint32_t interval, std::string& error) {
+    std::ifstream in(csv_path);
+    if (!in) {
+        error = csv_path + ": " + strerror(errno);
+        return -1;
+    }
+    TraceWriter out;
+    if (!out.Open(trace_path, interval)) {
+        error = trace_path + ": " + strerror(errno);
+        return -1;
+    }
+    std::string line;
+    long line_number = 0;
+    while (getline(in, line)) {
+        line_number++;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+            continue;
+        size_t comma = line.rfind(',');
+        const char* field = line.c_str() + (comma == std::string::npos ? 0 : comma + 1);
+        char* end;
+        double value = strtod(field, &end);
+        while (*end == ' ' || *end == '\t')
+            end++;
+        if (end == field || *end != '\0' || value < 0 || value > UINT32_MAX) {
+            if (line_number == 1)
+                continue;   // Záhlaví
+            error = csv_path + ":" + std::to_string(line_number) + ": neplatný počet požadavků";
+            out.Close();
+            return -1;
+        }
+        if (!out.Write((uint32_t)(value + 0.5))) {
+            error = trace_path + ": " + strerror(errno);
+            out.Close();
+            return -1;
+        }
+    }
+    if (!out.Close()) {
+        error = trace_path + ": " + strerror(errno);
+        return -1;
+    }
+    return out.Records();
+}
+
+/* PŘEVOD CSV -> TRACE POŽADAVKŮ */
+// Jeden požadavek na řádek: čas příchodu, doba zpracování (v sekundách).
+// Časy musí být neklesající, ukládají se relativně k prvnímu požadavku.
+// Záhlaví, prázdné řádky a komentáře jako u ConvertCsvTrace.
+// Vrací počet záznamů, při chybě -1 a popis v error.
+inline long ConvertCsvRequestTrace(const std::string& csv_path, const std::string& trace_path,
+                                   std::string& error) {
+    std::ifstream in(csv_path);
+    if (!in) {
+        error = csv_path + ": " + strerror(errno);
+        return -1;
+    }
+    TraceWriter out;
+    if (!out.Open(trace_path, 0, REQUEST_TRACE_MAGIC)) {
+        error = trace_path + ": " + strerror(errno);
+        return -1;
+    }
+    std::string line;
+    long line_number = 0;
+    double first = 0, last = 0;
+    while (getline(in, line)) {
+        line_number++;
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+        if (line.empty() || line[0] == '#')
+            continue;
+        const char* field = line.c_str();
+        char* end;
+        RequestRecord r;
+        r.time = strtod(field, &end);
+        bool ok = end != field && *end == ',';
+        if (ok) {
+            field = end + 1;
+            r.service_demand = strtod(field, &end);
+            while (*end == ' ' || *end == '\t')
+                end++;
+            ok = end != field && *end == '\0' && r.service_demand >= 0;
+        }
+        if (!ok && line_number == 1)
+            continue;   // Záhlaví
+        if (ok && out.Records() == 0)
+            first = last = r.time;
+        if (!ok || r.time < last) {
+            error = csv_path + ":" + std::to_string(line_number) +
+                    (ok ? ": časy příchodů nejsou seřazené" : ": očekáváno čas,doba_zpracování");
+            out.Close();
+            return -1;
+        }
+        last = r.time;
+        r.time -= first;
+        if (!out.Write(r)) {
+            error = trace_path + ": " + strerror(errno);
+            out.Close();
+            return -1;
+        }
+    }
+    if (!out.Close()) {
+        error = trace_path + ": " + strerror(errno);
+        return -1;
+    }
+    if (out.Records() == 0) {
+        error = csv_path + ": žádné požadavky";
+        return -1;
+    }
+    return out.Records();
+}
+
+#endif // TRACE_HPP
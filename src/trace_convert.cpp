@@ -0,0 +1,72 @@
+/*
+ *  Název programu: Převod zátěže do binárního trace (viz trace.hpp)
+ *
+ *  Použití: ./trace_convert [-i interval] vstup.csv výstup.trace
+ *           ./trace_convert -d výstup.trace
+ *           ./trace_convert -r vstup.csv výstup.trace
+ *
+ *    -i interval   délka intervalu jednoho řádku CSV v sekundách (60)
+ *    -d            uloží vestavěný dataset.hpp (jeden den po minutách)
+ *    -r            trace jednotlivých požadavků: řádky čas,doba_zpracování
+ */
+
+#include <iostream>
+#include <string>
+
+#include "dataset.hpp"
+#include "trace.hpp"
+
+using namespace std;
+
+void Usage(const char* program) {
+    cerr << "Použití: " << program << " [-i interval] vstup.csv výstup.trace\n"
+            "         " << program << " -d výstup.trace\n"
+            "         " << program << " -r vstup.csv výstup.trace\n";
+}
+
+int main(int argc, char* argv[]) {
+    uint32_t interval = 60;
+    int i = 1;
+
+    if (argc == 3 && string(argv[1]) == "-d") {
+        TraceWriter out;
+        bool ok = out.Open(argv[2], interval);
+        for (int requests : requests_per_minute)
+            ok = ok && out.Write(requests);
+        if (!out.Close() || !ok) {
+            cerr << argv[2] << ": " << strerror(errno) << endl;
+            return 1;
+        }
+        cout << argv[2] << ": " << out.Records() << " záznamů po " << interval << " s" << endl;
+        return 0;
+    }
+
+    if (argc == 4 && string(argv[1]) == "-r") {
+        string error;
+        long records = ConvertCsvRequestTrace(argv[2], argv[3], error);
+        if (records < 0) {
+            cerr << error << endl;
+            return 1;
+        }
+        cout << argv[3] << ": " << records << " požadavků" << endl;
+        return 0;
+    }
+
+    if (argc == 5 && string(argv[1]) == "-i") {
+        interval = atoi(argv[2]);
+        i = 3;
+    }
+    if (argc - i != 2 || interval == 0) {
+        Usage(argv[0]);
+        return 1;
+    }
+
+    string error;
+    long records = ConvertCsvTrace(argv[i], argv[i + 1], interval, error);
+    if (records < 0) {
+        cerr << error << endl;
+        return 1;
+    }
+    cout << argv[i + 1] << ": " << records << " záznamů po " << interval << " s" << endl;
+    return 0;
+}